@@ -2,7 +2,8 @@
 #define USB_POLLING_INTERVAL_MS 10
 #define SERIAL_NUMBER "JRaem/Azwx4o"
 #define LAYER_STATE_16BIT
-#define COMBO_COUNT 4
+#define COMBO_TERM_PER_COMBO
+#define COMBO_SHOULD_TRIGGER
 
 #define RGB_MATRIX_STARTUP_SPD 60
 
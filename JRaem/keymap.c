@@ -116,17 +116,8 @@ const key_override_t *key_overrides[] = {
 };
 
 
-const uint16_t PROGMEM combo0[] = { KC_DOT, OSM(MOD_LSFT), COMBO_END};
-const uint16_t PROGMEM combo1[] = { OSM(MOD_LSFT), DE_QUOT, COMBO_END};
-const uint16_t PROGMEM combo2[] = { KC_DOT, OSM(MOD_LSFT), COMBO_END};
-const uint16_t PROGMEM combo3[] = { DE_QUOT, OSM(MOD_LSFT), COMBO_END};
-
-combo_t key_combos[COMBO_COUNT] = {
-    COMBO(combo0, KC_COMMA),
-    COMBO(combo1, DE_DQOT),
-    COMBO(combo2, KC_COMMA),
-    COMBO(combo3, DE_DQOT),
-};
+// Generated from combos.json by tools/combos/gen_combos.py.
+#include "combos.inc"
 
 
 
@@ -134,36 +125,43 @@ extern rgb_config_t rgb_matrix_config;
 
 RGB hsv_to_rgb_with_value(HSV hsv) {
   RGB rgb = hsv_to_rgb( hsv );
-  float f = (float)rgb_matrix_config.hsv.v / UINT8_MAX;
-  return (RGB){ f * rgb.r, f * rgb.g, f * rgb.b };
+  uint8_t v = rgb_matrix_config.hsv.v;
+  return (RGB){ (uint16_t)rgb.r * v / UINT8_MAX, (uint16_t)rgb.g * v / UINT8_MAX, (uint16_t)rgb.b * v / UINT8_MAX };
 }
 
 void keyboard_post_init_user(void) {
   rgb_matrix_enable();
 }
 
-const uint8_t PROGMEM ledmap[][RGB_MATRIX_LED_COUNT][3] = {
-    [0] = { {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {139,78,233}, {139,149,221}, {139,210,188}, {68,239,219}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {68,239,219}, {0,0,0}, {68,239,219}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0} },
-
-    [4] = { {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {139,237,161}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {139,237,161}, {0,0,0}, {139,237,161}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0} },
+#include "ledmap.inc"
 
-    [9] = { {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {139,238,159}, {0,0,0}, {68,218,204}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0} },
+// RGB frame for the last ledmap layer drawn, already scaled to the global
+// brightness. Rebuilt only when the layer or brightness changes.
+static RGB     layer_frame[RGB_MATRIX_LED_COUNT];
+static int     layer_frame_layer = -1;
+static uint8_t layer_frame_v;
 
-};
+static void build_layer_frame(int layer) {
+  memset(layer_frame, 0, sizeof(layer_frame));
+  uint16_t end = pgm_read_word(&ledmap_offsets[layer + 1]);
+  for (uint16_t e = pgm_read_word(&ledmap_offsets[layer]); e < end; e++) {
+    HSV hsv = {
+      .h = pgm_read_byte(&ledmap_entries[e].h),
+      .s = pgm_read_byte(&ledmap_entries[e].s),
+      .v = pgm_read_byte(&ledmap_entries[e].v),
+    };
+    layer_frame[pgm_read_byte(&ledmap_entries[e].led)] = hsv_to_rgb_with_value(hsv);
+  }
+  layer_frame_layer = layer;
+  layer_frame_v = rgb_matrix_config.hsv.v;
+}
 
 void set_layer_color(int layer) {
+  if (layer != layer_frame_layer || rgb_matrix_config.hsv.v != layer_frame_v) {
+    build_layer_frame(layer);
+  }
   for (int i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
-    HSV hsv = {
-      .h = pgm_read_byte(&ledmap[layer][i][0]),
-      .s = pgm_read_byte(&ledmap[layer][i][1]),
-      .v = pgm_read_byte(&ledmap[layer][i][2]),
-    };
-    if (!hsv.h && !hsv.s && !hsv.v) {
-        rgb_matrix_set_color( i, 0, 0, 0 );
-    } else {
-        RGB rgb = hsv_to_rgb_with_value(hsv);
-        rgb_matrix_set_color(i, rgb.r, rgb.g, rgb.b);
-    }
+    rgb_matrix_set_color(i, layer_frame[i].r, layer_frame[i].g, layer_frame[i].b);
   }
 }
 
@@ -172,20 +170,11 @@ bool rgb_matrix_indicators_user(void) {
       return false;
   }
   if (!keyboard_config.disable_layer_led) { 
-    switch (biton32(layer_state)) {
-      case 0:
-        set_layer_color(0);
-        break;
-      case 4:
-        set_layer_color(4);
-        break;
-      case 9:
-        set_layer_color(9);
-        break;
-     default:
-        if (rgb_matrix_get_flags() == LED_FLAG_NONE) {
-          rgb_matrix_set_color_all(0, 0, 0);
-        }
+    uint8_t layer = biton32(layer_state);
+    if (layer < LEDMAP_LAYER_COUNT && (LEDMAP_LAYERS & (1 << layer))) {
+      set_layer_color(layer);
+    } else if (rgb_matrix_get_flags() == LED_FLAG_NONE) {
+      rgb_matrix_set_color_all(0, 0, 0);
     }
   } else {
     if (rgb_matrix_get_flags() == LED_FLAG_NONE) {
@@ -197,249 +186,60 @@ bool rgb_matrix_indicators_user(void) {
 }
 
 
+// Tap and hold actions behind each DUAL_FUNC_n sentinel. The LT() layer in
+// the sentinel is never activated; process_record_user only uses
+// record->tap.count to pick between the two keycodes below.
+typedef struct {
+  uint16_t key;
+  uint16_t tap;
+  uint16_t hold;
+} dual_func_t;
+
+const dual_func_t PROGMEM dual_funcs[] = {
+  { DUAL_FUNC_0,  DE_AT,     KC_LEFT_CTRL },
+  { DUAL_FUNC_1,  DE_SLSH,   KC_LEFT_ALT },
+  { DUAL_FUNC_2,  DE_LCBR,   KC_LEFT_GUI },
+  { DUAL_FUNC_3,  DE_RPRN,   KC_RIGHT_GUI },
+  { DUAL_FUNC_4,  DE_COLN,   KC_RIGHT_CTRL },
+  { DUAL_FUNC_5,  KC_BSPC,   LCTL(KC_BSPC) },
+  { DUAL_FUNC_6,  KC_DELETE, LCTL(KC_DELETE) },
+  { DUAL_FUNC_7,  DE_EURO,   KC_LEFT_GUI },
+  { DUAL_FUNC_8,  KC_EQUAL,  KC_ESCAPE },
+  { DUAL_FUNC_9,  DE_EURO,   KC_LEFT_CTRL },
+  { DUAL_FUNC_10, DE_AT,     KC_LEFT_GUI },
+  { DUAL_FUNC_11, DE_LCBR,   KC_LEFT_CTRL },
+  { DUAL_FUNC_12, DE_RPRN,   KC_RIGHT_CTRL },
+  { DUAL_FUNC_13, DE_COLN,   KC_RIGHT_GUI },
+  { DUAL_FUNC_14, KC_BSPC,   LALT(KC_BSPC) },
+  { DUAL_FUNC_15, KC_DELETE, LALT(KC_DELETE) },
+};
+
+// Handles a DUAL_FUNC_n press or release. Returns false if keycode is not
+// one of the sentinels.
+static bool process_dual_func(uint16_t keycode, keyrecord_t *record) {
+  if (!IS_QK_LAYER_TAP(keycode)) {
+    return false;
+  }
+  for (uint8_t i = 0; i < ARRAY_SIZE(dual_funcs); i++) {
+    if (pgm_read_word(&dual_funcs[i].key) != keycode) {
+      continue;
+    }
+    uint16_t code = record->tap.count > 0 ? pgm_read_word(&dual_funcs[i].tap) : pgm_read_word(&dual_funcs[i].hold);
+    if (record->event.pressed) {
+      register_code16(code);
+    } else {
+      unregister_code16(code);
+    }
+    return true;
+  }
+  return false;
+}
+
 bool process_record_user(uint16_t keycode, keyrecord_t *record) {
+  if (process_dual_func(keycode, record)) {
+    return false;
+  }
   switch (keycode) {
-
-    case DUAL_FUNC_0:
-      if (record->tap.count > 0) {
-        if (record->event.pressed) {
-          register_code16(DE_AT);
-        } else {
-          unregister_code16(DE_AT);
-        }
-      } else {
-        if (record->event.pressed) {
-          register_code16(KC_LEFT_CTRL);
-        } else {
-          unregister_code16(KC_LEFT_CTRL);
-        }  
-      }  
-      return false;
-    case DUAL_FUNC_1:
-      if (record->tap.count > 0) {
-        if (record->event.pressed) {
-          register_code16(DE_SLSH);
-        } else {
-          unregister_code16(DE_SLSH);
-        }
-      } else {
-        if (record->event.pressed) {
-          register_code16(KC_LEFT_ALT);
-        } else {
-          unregister_code16(KC_LEFT_ALT);
-        }  
-      }  
-      return false;
-    case DUAL_FUNC_2:
-      if (record->tap.count > 0) {
-        if (record->event.pressed) {
-          register_code16(DE_LCBR);
-        } else {
-          unregister_code16(DE_LCBR);
-        }
-      } else {
-        if (record->event.pressed) {
-          register_code16(KC_LEFT_GUI);
-        } else {
-          unregister_code16(KC_LEFT_GUI);
-        }  
-      }  
-      return false;
-    case DUAL_FUNC_3:
-      if (record->tap.count > 0) {
-        if (record->event.pressed) {
-          register_code16(DE_RPRN);
-        } else {
-          unregister_code16(DE_RPRN);
-        }
-      } else {
-        if (record->event.pressed) {
-          register_code16(KC_RIGHT_GUI);
-        } else {
-          unregister_code16(KC_RIGHT_GUI);
-        }  
-      }  
-      return false;
-    case DUAL_FUNC_4:
-      if (record->tap.count > 0) {
-        if (record->event.pressed) {
-          register_code16(DE_COLN);
-        } else {
-          unregister_code16(DE_COLN);
-        }
-      } else {
-        if (record->event.pressed) {
-          register_code16(KC_RIGHT_CTRL);
-        } else {
-          unregister_code16(KC_RIGHT_CTRL);
-        }  
-      }  
-      return false;
-    case DUAL_FUNC_5:
-      if (record->tap.count > 0) {
-        if (record->event.pressed) {
-          register_code16(KC_BSPC);
-        } else {
-          unregister_code16(KC_BSPC);
-        }
-      } else {
-        if (record->event.pressed) {
-          register_code16(LCTL(KC_BSPC));
-        } else {
-          unregister_code16(LCTL(KC_BSPC));
-        }  
-      }  
-      return false;
-    case DUAL_FUNC_6:
-      if (record->tap.count > 0) {
-        if (record->event.pressed) {
-          register_code16(KC_DELETE);
-        } else {
-          unregister_code16(KC_DELETE);
-        }
-      } else {
-        if (record->event.pressed) {
-          register_code16(LCTL(KC_DELETE));
-        } else {
-          unregister_code16(LCTL(KC_DELETE));
-        }  
-      }  
-      return false;
-    case DUAL_FUNC_7:
-      if (record->tap.count > 0) {
-        if (record->event.pressed) {
-          register_code16(DE_EURO);
-        } else {
-          unregister_code16(DE_EURO);
-        }
-      } else {
-        if (record->event.pressed) {
-          register_code16(KC_LEFT_GUI);
-        } else {
-          unregister_code16(KC_LEFT_GUI);
-        }  
-      }  
-      return false;
-    case DUAL_FUNC_8:
-      if (record->tap.count > 0) {
-        if (record->event.pressed) {
-          register_code16(KC_EQUAL);
-        } else {
-          unregister_code16(KC_EQUAL);
-        }
-      } else {
-        if (record->event.pressed) {
-          register_code16(KC_ESCAPE);
-        } else {
-          unregister_code16(KC_ESCAPE);
-        }  
-      }  
-      return false;
-    case DUAL_FUNC_9:
-      if (record->tap.count > 0) {
-        if (record->event.pressed) {
-          register_code16(DE_EURO);
-        } else {
-          unregister_code16(DE_EURO);
-        }
-      } else {
-        if (record->event.pressed) {
-          register_code16(KC_LEFT_CTRL);
-        } else {
-          unregister_code16(KC_LEFT_CTRL);
-        }  
-      }  
-      return false;
-    case DUAL_FUNC_10:
-      if (record->tap.count > 0) {
-        if (record->event.pressed) {
-          register_code16(DE_AT);
-        } else {
-          unregister_code16(DE_AT);
-        }
-      } else {
-        if (record->event.pressed) {
-          register_code16(KC_LEFT_GUI);
-        } else {
-          unregister_code16(KC_LEFT_GUI);
-        }  
-      }  
-      return false;
-    case DUAL_FUNC_11:
-      if (record->tap.count > 0) {
-        if (record->event.pressed) {
-          register_code16(DE_LCBR);
-        } else {
-          unregister_code16(DE_LCBR);
-        }
-      } else {
-        if (record->event.pressed) {
-          register_code16(KC_LEFT_CTRL);
-        } else {
-          unregister_code16(KC_LEFT_CTRL);
-        }  
-      }  
-      return false;
-    case DUAL_FUNC_12:
-      if (record->tap.count > 0) {
-        if (record->event.pressed) {
-          register_code16(DE_RPRN);
-        } else {
-          unregister_code16(DE_RPRN);
-        }
-      } else {
-        if (record->event.pressed) {
-          register_code16(KC_RIGHT_CTRL);
-        } else {
-          unregister_code16(KC_RIGHT_CTRL);
-        }  
-      }  
-      return false;
-    case DUAL_FUNC_13:
-      if (record->tap.count > 0) {
-        if (record->event.pressed) {
-          register_code16(DE_COLN);
-        } else {
-          unregister_code16(DE_COLN);
-        }
-      } else {
-        if (record->event.pressed) {
-          register_code16(KC_RIGHT_GUI);
-        } else {
-          unregister_code16(KC_RIGHT_GUI);
-        }  
-      }  
-      return false;
-    case DUAL_FUNC_14:
-      if (record->tap.count > 0) {
-        if (record->event.pressed) {
-          register_code16(KC_BSPC);
-        } else {
-          unregister_code16(KC_BSPC);
-        }
-      } else {
-        if (record->event.pressed) {
-          register_code16(LALT(KC_BSPC));
-        } else {
-          unregister_code16(LALT(KC_BSPC));
-        }  
-      }  
-      return false;
-    case DUAL_FUNC_15:
-      if (record->tap.count > 0) {
-        if (record->event.pressed) {
-          register_code16(KC_DELETE);
-        } else {
-          unregister_code16(KC_DELETE);
-        }
-      } else {
-        if (record->event.pressed) {
-          register_code16(LALT(KC_DELETE));
-        } else {
-          unregister_code16(LALT(KC_DELETE));
-        }  
-      }  
-      return false;
     case RGB_SLD:
       if (record->event.pressed) {
         rgblight_mode(1);
@@ -0,0 +1,227 @@
+#!/usr/bin/env python3
+"""Generate the combo table and its key index for a layout.
+
+The source is <layout>/combos.json:
+
+    {
+      "combos": [
+        {"keys": ["OSL(LAYER_MOVEMENT)", "KC_DOT"], "output": "KC_COMMA",
+         "term": 40, "start": ["OSL(LAYER_MOVEMENT)"]},
+        ...
+      ]
+    }
+
+`keys` and `output` are C keycode expressions. `term` (ms) defaults to
+COMBO_TERM. `start` lists the keys that may begin the combo and defaults to
+all of them; any other key of the combo only counts while the combo is
+already under way, so on its own it is sent without waiting in the combo
+buffer.
+
+Combos with the same set of keys and the same output are merged, whatever
+the key order; the same keys with a different output is an error.
+
+The output, <layout>/combos.inc, holds key_combos, the per-combo terms, a
+per-keycode bitmask index and the get_combo_term/combo_should_trigger hooks
+that use them (COMBO_TERM_PER_COMBO and COMBO_SHOULD_TRIGGER in config.h).
+
+Usage:
+    gen_combos.py <layout_dir>                  write combos.inc
+    gen_combos.py --check <layout_dir>          fail if combos.inc is stale
+    gen_combos.py --import-c <file> <layout_dir>
+        convert the comboN[]/key_combos[] tables found in <file> (as Oryx
+        exports them) into combos.json, then write combos.inc
+"""
+
+import argparse
+import json
+import os
+import re
+import sys
+
+# Combos are tracked in a uint16_t bitmask.
+MAX_COMBOS = 16
+
+
+def norm(expr):
+    return "".join(expr.split())
+
+
+def load_json(path):
+    with open(path) as f:
+        data = json.load(f)
+    return merge(data.get("combos", []), path)
+
+
+def merge(entries, path):
+    """Validate combo entries and drop repeats of the same combo."""
+    combos = []
+    by_keys = {}
+    for i, c in enumerate(entries):
+        keys = c.get("keys")
+        output = c.get("output")
+        if not keys or len(keys) < 2 or not all(isinstance(k, str) and k.strip() for k in keys):
+            raise ValueError(f"{path}: combo {i}: 'keys' must list at least two keycodes")
+        if not isinstance(output, str) or not output.strip():
+            raise ValueError(f"{path}: combo {i}: 'output' must be a keycode")
+        keys = [norm(k) for k in keys]
+        if len(set(keys)) != len(keys):
+            raise ValueError(f"{path}: combo {i}: a key is listed twice")
+        term = c.get("term")
+        if term is not None and not (isinstance(term, int) and 0 < term < 65536):
+            raise ValueError(f"{path}: combo {i}: bad term {term}")
+        start = [norm(k) for k in c.get("start", keys)]
+        if not start or any(k not in keys for k in start):
+            raise ValueError(f"{path}: combo {i}: 'start' must be a non-empty subset of 'keys'")
+        combo = {"keys": keys, "output": norm(output), "term": term, "start": start}
+
+        key_set = frozenset(keys)
+        if key_set in by_keys:
+            j, other = by_keys[key_set]
+            if other["output"] != combo["output"]:
+                raise ValueError(f"{path}: combos {j} and {i} use the same keys for {other['output']} and {combo['output']}")
+            if (other["term"], set(other["start"])) != (term, set(start)):
+                raise ValueError(f"{path}: combos {j} and {i} are the same combo with different settings")
+            print(f"gen_combos: combo {i} repeats combo {j}, merged", file=sys.stderr)
+            continue
+        by_keys[key_set] = (i, combo)
+        combos.append(combo)
+    if not combos:
+        raise ValueError(f"{path}: no combos")
+    if len(combos) > MAX_COMBOS:
+        raise ValueError(f"{path}: {len(combos)} combos, at most {MAX_COMBOS} fit the index")
+    return combos
+
+
+def import_c(path):
+    """Parse Oryx-style `comboN[] = {..., COMBO_END}` and `COMBO(comboN, kc)`."""
+    with open(path) as f:
+        src = f.read()
+    arrays = {m.group(1): [k.strip() for k in m.group(2).split(",") if k.strip()]
+              for m in re.finditer(r"const\s+uint16_t\s+PROGMEM\s+(\w+)\s*\[\s*\]\s*=\s*\{(.*?)\bCOMBO_END\s*\}", src, re.S)}
+    combos = []
+    for m in re.finditer(r"\bCOMBO\s*\(\s*(\w+)\s*,\s*(.*?)\)\s*,?\s*(?=COMBO\s*\(|\})", src, re.S):
+        name, output = m.group(1), m.group(2).strip()
+        if name not in arrays:
+            raise ValueError(f"{path}: COMBO({name}, ...) refers to an unknown key array")
+        combos.append({"keys": arrays[name], "output": output})
+    if not combos:
+        raise ValueError(f"{path}: no combos found")
+    return combos
+
+
+def write_json(path, combos):
+    lines = ["{", '  "combos": [']
+    for i, c in enumerate(combos):
+        fields = [f'"keys": {json.dumps(c["keys"])}', f'"output": {json.dumps(c["output"])}']
+        if c.get("term") is not None:
+            fields.append(f'"term": {c["term"]}')
+        if c.get("start") is not None and c["start"] != c["keys"]:
+            fields.append(f'"start": {json.dumps(c["start"])}')
+        lines.append("    {" + ", ".join(fields) + "}" + ("," if i + 1 < len(combos) else ""))
+    lines += ["  ]", "}", ""]
+    with open(path, "w") as f:
+        f.write("\n".join(lines))
+
+
+def render(combos):
+    # Every distinct combo key with the combos it may begin.
+    index = {}
+    for i, c in enumerate(combos):
+        for k in c["keys"]:
+            index[k] = index.get(k, 0) | (1 << i if k in c["start"] else 0)
+
+    out = [
+        "// Generated by tools/combos/gen_combos.py from combos.json. Do not edit.",
+        "#pragma once",
+        "",
+    ]
+    for i, c in enumerate(combos):
+        out.append(f"const uint16_t PROGMEM combo{i}[] = {{ {', '.join(c['keys'])}, COMBO_END }};")
+    out += ["", "combo_t key_combos[] = {"]
+    for i, c in enumerate(combos):
+        out.append(f"  COMBO(combo{i}, {c['output']}),")
+    out += [
+        "};",
+        "",
+        "// How long each combo waits for the rest of its keys.",
+        f"const uint16_t PROGMEM combo_terms[] = {{ {', '.join(str(c['term']) if c['term'] else 'COMBO_TERM' for c in combos)} }};",
+        "",
+        "typedef struct {",
+        "  uint16_t keycode;",
+        "  uint16_t start; // combos the key may begin, bit n = key_combos[n]",
+        "} combo_key_t;",
+        "",
+        f"#define COMBO_KEY_COUNT {len(index)}",
+        "",
+        "const combo_key_t PROGMEM combo_keys[COMBO_KEY_COUNT] = {",
+    ]
+    for k, start in index.items():
+        out.append(f"  {{ {k}, 0x{start:04X} }},")
+    out += [
+        "};",
+        "",
+        "// Combos whose first key went down at combo_started_at[n].",
+        "static uint16_t combo_started;",
+        f"static uint16_t combo_started_at[{len(combos)}];",
+        "",
+        "uint16_t get_combo_term(uint16_t index, combo_t *combo) {",
+        "  return pgm_read_word(&combo_terms[index]);",
+        "}",
+        "",
+        "// A key joins a combo's buffer only if it may begin that combo or the",
+        "// combo was begun within its term; anything else goes straight through.",
+        "bool combo_should_trigger(uint16_t index, combo_t *combo, uint16_t keycode, keyrecord_t *record) {",
+        "  if (!record->event.pressed) {",
+        "    return true;",
+        "  }",
+        "  uint16_t bit = 1u << index;",
+        "  for (uint8_t i = 0; i < COMBO_KEY_COUNT; i++) {",
+        "    if (pgm_read_word(&combo_keys[i].keycode) != keycode) {",
+        "      continue;",
+        "    }",
+        "    if (pgm_read_word(&combo_keys[i].start) & bit) {",
+        "      combo_started |= bit;",
+        "      combo_started_at[index] = record->event.time;",
+        "      return true;",
+        "    }",
+        "    break;",
+        "  }",
+        "  return (combo_started & bit) && TIMER_DIFF_16(record->event.time, combo_started_at[index]) < get_combo_term(index, combo);",
+        "}",
+        "",
+    ]
+    return "\n".join(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("layout_dir")
+    parser.add_argument("--check", action="store_true", help="fail if combos.inc does not match combos.json")
+    parser.add_argument("--import-c", metavar="FILE", help="create combos.json from Oryx combo tables")
+    args = parser.parse_args()
+
+    json_path = os.path.join(args.layout_dir, "combos.json")
+    inc_path = os.path.join(args.layout_dir, "combos.inc")
+    try:
+        if args.import_c:
+            write_json(json_path, merge(import_c(args.import_c), args.import_c))
+        text = render(load_json(json_path))
+    except (OSError, ValueError) as e:
+        sys.exit(f"gen_combos: {e}")
+
+    if args.check:
+        try:
+            with open(inc_path) as f:
+                current = f.read()
+        except OSError:
+            current = None
+        if current != text:
+            sys.exit(f"gen_combos: {inc_path} is out of date, run tools/combos/gen_combos.py {args.layout_dir}")
+        return
+
+    with open(inc_path, "w") as f:
+        f.write(text)
+
+
+if __name__ == "__main__":
+    main()
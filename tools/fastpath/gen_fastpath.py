@@ -0,0 +1,278 @@
+#!/usr/bin/env python3
+"""Generate the fast-path keycode bitmap for a layout.
+
+Every key press normally runs the whole QMK pipeline: combos, the tap-hold
+state machine, caps word, leader, key overrides, repeat key and
+process_record_user. Most presses are plain letters and punctuation that
+none of these act on. This script marks those keycodes so that
+vrmer_fastpath.c can send them to the HID report straight away.
+
+A keycode is marked when
+  - it sits on its own in a slot of some layer (LAYOUT_voyager or a Windows
+    overlay), directly or through an i18n.h alias, so no mod-tap, layer-tap
+    or shifted alias;
+  - it is a plain keyboard usage from the table below, so no modifier,
+    media or system key and no custom keycode;
+  - it is not a key of any combo in combos.json, not the trigger of a key
+    override (ko_make_* in custom_layout.inc) and not a case label in
+    process_record_user;
+  - it is not one of the keys QMK's keycode_config() may swap (caps lock,
+    grave, escape, backslash, backspace), which register_code() would send
+    unswapped.
+
+Whether a marked key may take the fast path at a given moment (no tap-hold
+key held, no one-shot, caps word or leader sequence under way) is decided at
+run time, see vrmer_fastpath.h.
+
+The output, <layout>/fastpath.inc, holds vrmer_fastpath_keycodes[], one bit
+per keycode 0-255, and a static assertion that the keycode values the bitmap
+was built from match QMK's.
+
+Usage:
+    gen_fastpath.py <layout_dir>            write fastpath.inc
+    gen_fastpath.py --check <layout_dir>    fail if fastpath.inc is stale
+"""
+
+import argparse
+import json
+import os
+import re
+import sys
+
+# HID keyboard usages, long and short QMK names.
+USAGES = {}
+for i, c in enumerate("ABCDEFGHIJKLMNOPQRSTUVWXYZ"):
+    USAGES[f"KC_{c}"] = 0x04 + i
+for i, c in enumerate("1234567890"):
+    USAGES[f"KC_{c}"] = 0x1E + i
+for i in range(12):
+    USAGES[f"KC_F{i + 1}"] = 0x3A + i
+for i in range(12):
+    USAGES[f"KC_F{i + 13}"] = 0x68 + i
+for code, names in {
+    0x28: ("KC_ENTER", "KC_ENT"),
+    0x29: ("KC_ESCAPE", "KC_ESC"),
+    0x2A: ("KC_BACKSPACE", "KC_BSPC"),
+    0x2B: ("KC_TAB",),
+    0x2C: ("KC_SPACE", "KC_SPC"),
+    0x2D: ("KC_MINUS", "KC_MINS"),
+    0x2E: ("KC_EQUAL", "KC_EQL"),
+    0x2F: ("KC_LEFT_BRACKET", "KC_LBRC"),
+    0x30: ("KC_RIGHT_BRACKET", "KC_RBRC"),
+    0x31: ("KC_BACKSLASH", "KC_BSLS"),
+    0x32: ("KC_NONUS_HASH", "KC_NUHS"),
+    0x33: ("KC_SEMICOLON", "KC_SCLN"),
+    0x34: ("KC_QUOTE", "KC_QUOT"),
+    0x35: ("KC_GRAVE", "KC_GRV"),
+    0x36: ("KC_COMMA", "KC_COMM"),
+    0x37: ("KC_DOT",),
+    0x38: ("KC_SLASH", "KC_SLSH"),
+    0x39: ("KC_CAPS_LOCK", "KC_CAPS"),
+    0x46: ("KC_PRINT_SCREEN", "KC_PSCR"),
+    0x48: ("KC_PAUSE", "KC_PAUS"),
+    0x49: ("KC_INSERT", "KC_INS"),
+    0x4A: ("KC_HOME",),
+    0x4B: ("KC_PAGE_UP", "KC_PGUP"),
+    0x4C: ("KC_DELETE", "KC_DEL"),
+    0x4D: ("KC_END",),
+    0x4E: ("KC_PAGE_DOWN", "KC_PGDN"),
+    0x4F: ("KC_RIGHT", "KC_RGHT"),
+    0x50: ("KC_LEFT",),
+    0x51: ("KC_DOWN",),
+    0x52: ("KC_UP",),
+    0x64: ("KC_NONUS_BACKSLASH", "KC_NUBS"),
+    0x65: ("KC_APPLICATION", "KC_APP"),
+}.items():
+    for name in names:
+        USAGES[name] = code
+
+# Keys keycode_config() may swap (magic keycodes); register_code() skips it.
+SWAPPABLE = {0x29, 0x2A, 0x31, 0x35, 0x39}
+
+
+def norm(expr):
+    return "".join(expr.split())
+
+
+def strip_comments(src):
+    return re.sub(r"//[^\n]*|/\*.*?\*/", "", src, flags=re.S)
+
+
+def split_args(body):
+    """Split a macro argument list at top-level commas."""
+    args, depth, cur = [], 0, ""
+    for ch in body:
+        if ch == "(":
+            depth += 1
+        elif ch == ")":
+            depth -= 1
+        if ch == "," and depth == 0:
+            args.append(cur)
+            cur = ""
+        else:
+            cur += ch
+    args.append(cur)
+    return [norm(a) for a in args if a.strip()]
+
+
+def call_body(src, start):
+    """Text between the parenthesis at src[start] and its match."""
+    depth = 0
+    for i in range(start, len(src)):
+        if src[i] == "(":
+            depth += 1
+        elif src[i] == ")":
+            depth -= 1
+            if depth == 0:
+                return src[start + 1:i]
+    raise ValueError("unbalanced parentheses")
+
+
+def function_body(src, name):
+    m = re.search(r"\b" + name + r"\s*\([^)]*\)\s*\{", src)
+    if not m:
+        return ""
+    depth = 0
+    for i in range(m.end() - 1, len(src)):
+        if src[i] == "{":
+            depth += 1
+        elif src[i] == "}":
+            depth -= 1
+            if depth == 0:
+                return src[m.end():i]
+    raise ValueError(f"unbalanced braces in {name}")
+
+
+class Layout:
+    def __init__(self, layout_dir):
+        with open(os.path.join(layout_dir, "custom_layout.inc")) as f:
+            self.src = strip_comments(f.read())
+        self.defines = {}
+        with open(os.path.join(layout_dir, "i18n.h")) as f:
+            for m in re.finditer(r"^#define\s+(\w+)\s+(.+)$", f.read(), re.M):
+                self.defines[m.group(1)] = norm(m.group(2))
+        with open(os.path.join(layout_dir, "combos.json")) as f:
+            self.combos = json.load(f).get("combos", [])
+
+    def expand(self, expr):
+        seen = set()
+        while expr in self.defines and expr not in seen:
+            seen.add(expr)
+            expr = self.defines[expr]
+        return expr
+
+    def slots(self):
+        """Every keycode expression placed in a slot, keymap and overlays."""
+        found = []
+        for m in re.finditer(r"\bLAYOUT_voyager\s*\(", self.src):
+            found += split_args(call_body(self.src, m.end() - 1))
+        for m in re.finditer(r"\{\s*VOYAGER_SLOT\s*\(\s*\d+\s*\)\s*,\s*(.*?)\s*\}\s*,", self.src):
+            found.append(norm(m.group(1)))
+        if not found:
+            raise ValueError("no LAYOUT_voyager keymap found in custom_layout.inc")
+        return found
+
+    def excluded(self):
+        """Keycodes the full pipeline has to see, with the reason."""
+        out = {}
+        for c in self.combos:
+            for k in c.get("keys", []):
+                out.setdefault(self.expand(norm(k)), "combo key")
+        for m in re.finditer(r"\bko_make_\w+\s*\(", self.src):
+            args = split_args(call_body(self.src, m.end() - 1))
+            if len(args) >= 2:
+                out.setdefault(self.expand(args[1]), "key override trigger")
+        for m in re.finditer(r"\bcase\s+([^:]+):", function_body(self.src, "process_record_user")):
+            out.setdefault(self.expand(norm(m.group(1))), "process_record_user")
+        return out
+
+
+def classify(layout):
+    excluded = layout.excluded()
+    fast, slow = {}, {}
+    for expr in layout.slots():
+        kc = layout.expand(expr)
+        if kc not in USAGES:
+            continue
+        code = USAGES[kc]
+        if kc in excluded:
+            slow[kc] = excluded[kc]
+        elif code in SWAPPABLE:
+            slow[kc] = "keycode_config"
+        else:
+            fast[kc] = code
+    # The same usage under two names is only fast if neither is excluded.
+    slow_codes = {USAGES[kc] for kc in slow}
+    for kc in [kc for kc, code in fast.items() if code in slow_codes]:
+        slow[kc] = "alias of an excluded key"
+        del fast[kc]
+    return fast, slow
+
+
+def render(fast, slow):
+    bitmap = [0] * 32
+    for code in fast.values():
+        bitmap[code >> 3] |= 1 << (code & 7)
+    names = sorted(fast, key=lambda kc: (fast[kc], kc))
+
+    out = [
+        "// Generated by tools/fastpath/gen_fastpath.py from the keymap. Do not edit.",
+        "#pragma once",
+        "",
+        "// Plain keycodes that may skip the full pipeline, bit (kc & 7) of byte kc >> 3:",
+    ]
+    line = "//"
+    for kc in names:
+        if len(line) + len(kc) + 1 > 80:
+            out.append(line)
+            line = "//"
+        line += " " + kc
+    out.append(line)
+    if slow:
+        out.append("// Kept on the full pipeline:")
+        for kc in sorted(slow):
+            out.append(f"//   {kc} ({slow[kc]})")
+    out += ["const uint8_t PROGMEM vrmer_fastpath_keycodes[32] = {"]
+    for row in range(0, 32, 8):
+        out.append("  " + ", ".join(f"0x{b:02X}" for b in bitmap[row:row + 8]) + ",")
+    out += ["};", ""]
+    checks = [f"{kc} == 0x{fast[kc]:02X}" for kc in names]
+    out.append("_Static_assert(")
+    for i in range(0, len(checks), 4):
+        tail = " &&" if i + 4 < len(checks) else ","
+        out.append("  " + " && ".join(checks[i:i + 4]) + tail)
+    out += ['  "fastpath.inc was built for other keycode values, run tools/fastpath/gen_fastpath.py");', ""]
+    return "\n".join(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("layout_dir")
+    parser.add_argument("--check", action="store_true", help="fail if fastpath.inc does not match the keymap")
+    args = parser.parse_args()
+
+    inc_path = os.path.join(args.layout_dir, "fastpath.inc")
+    try:
+        fast, slow = classify(Layout(args.layout_dir))
+        if not fast:
+            raise ValueError("no keycode qualifies for the fast path")
+        text = render(fast, slow)
+    except (OSError, ValueError) as e:
+        sys.exit(f"gen_fastpath: {e}")
+
+    if args.check:
+        try:
+            with open(inc_path) as f:
+                current = f.read()
+        except OSError:
+            current = None
+        if current != text:
+            sys.exit(f"gen_fastpath: {inc_path} is out of date, run tools/fastpath/gen_fastpath.py {args.layout_dir}")
+        return
+
+    with open(inc_path, "w") as f:
+        f.write(text)
+
+
+if __name__ == "__main__":
+    main()
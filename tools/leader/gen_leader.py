@@ -0,0 +1,176 @@
+#!/usr/bin/env python3
+"""Generate the leader sequence trie for a layout.
+
+The source is <layout>/leader.json:
+
+    {
+      "sequences": [
+        {"keys": ["KC_C", "KC_E"], "tap": "DE_EURO"},
+        {"keys": ["KC_A"], "tap": "DE_AE", "shift": true},
+        ...
+      ]
+    }
+
+`keys` and `tap` are C keycode expressions as they would appear in the
+keymap. With `"shift": true` the tap carries Shift when a Shift modifier is
+held as the sequence ends.
+
+The output, <layout>/leader.inc, is a breadth-first prefix trie in PROGMEM
+that leader_add_user walks key by key. A sequence finishes as soon as no
+longer sequence can follow it. A sequence that is a prefix of another one can
+only be told apart by LEADER_TIMEOUT; every such prefix is reported here and
+again as a compiler note when the firmware is built.
+
+Usage:
+    gen_leader.py <layout_dir>              write leader.inc
+    gen_leader.py --check <layout_dir>      fail if leader.inc is stale
+"""
+
+import argparse
+import json
+import os
+import sys
+
+# QMK's leader_sequence holds five keys.
+MAX_KEYS = 5
+MAX_NODES = 255
+
+
+def norm(expr):
+    return "".join(expr.split())
+
+
+def load_json(path):
+    with open(path) as f:
+        data = json.load(f)
+    sequences = []
+    seen = {}
+    for i, seq in enumerate(data.get("sequences", [])):
+        keys = seq.get("keys")
+        tap = seq.get("tap")
+        if not keys or not all(isinstance(k, str) and k.strip() for k in keys):
+            raise ValueError(f"{path}: sequence {i}: 'keys' must be a non-empty list of keycodes")
+        if len(keys) > MAX_KEYS:
+            raise ValueError(f"{path}: sequence {i}: more than {MAX_KEYS} keys")
+        if not isinstance(tap, str) or not tap.strip():
+            raise ValueError(f"{path}: sequence {i}: 'tap' must be a keycode")
+        key = tuple(norm(k) for k in keys)
+        if key in seen:
+            raise ValueError(f"{path}: sequence {i} repeats sequence {seen[key]} ({' '.join(keys)})")
+        seen[key] = i
+        sequences.append((key, norm(tap), bool(seq.get("shift", False))))
+    if not sequences:
+        raise ValueError(f"{path}: no sequences")
+    return sequences
+
+
+class Node:
+    def __init__(self, keycode):
+        self.keycode = keycode
+        self.tap = None
+        self.shift = False
+        self.children = []
+
+
+def build(sequences):
+    root = Node(None)
+    for keys, tap, shift in sequences:
+        node = root
+        for k in keys:
+            child = next((c for c in node.children if c.keycode == k), None)
+            if child is None:
+                child = Node(k)
+                node.children.append(child)
+            node = child
+        node.tap = tap
+        node.shift = shift
+    # Breadth-first, so every node's children end up next to each other.
+    order = [root]
+    for node in order:
+        order.extend(node.children)
+    if len(order) > MAX_NODES:
+        raise ValueError(f"{len(order)} trie nodes, at most {MAX_NODES} fit the index type")
+    return order
+
+
+def ambiguities(sequences):
+    """Pairs (prefix, longer) where one sequence starts another."""
+    found = []
+    for keys, _, _ in sequences:
+        longer = [k for k, _, _ in sequences if len(k) > len(keys) and k[: len(keys)] == keys]
+        if longer:
+            found.append((keys, min(longer, key=len)))
+    return found
+
+
+def render(sequences):
+    order = build(sequences)
+    index = {id(n): i for i, n in enumerate(order)}
+    out = [
+        "// Generated by tools/leader/gen_leader.py from leader.json. Do not edit.",
+        "#pragma once",
+        "",
+        "// Tap with Shift when a Shift modifier is held as the sequence ends.",
+        "#define LEADER_SHIFT 0x01",
+        "",
+        "typedef struct {",
+        "  uint16_t keycode;  // key leading here from the parent",
+        "  uint16_t tap;      // keycode sent when the sequence ends here, KC_NO if none",
+        "  uint8_t  child;    // index of the first child",
+        "  uint8_t  children;",
+        "  uint8_t  flags;",
+        "} leader_node_t;",
+        "",
+        f"#define LEADER_NODE_COUNT {len(order)}",
+        "",
+        "// Breadth-first; node 0 is the root and a node's children are contiguous.",
+        "const leader_node_t PROGMEM leader_trie[LEADER_NODE_COUNT] = {",
+    ]
+    for i, node in enumerate(order):
+        first = index[id(node.children[0])] if node.children else 0
+        flags = "LEADER_SHIFT" if node.shift else "0"
+        out.append(f"  /* {i:2d} */ {{ {node.keycode or 'KC_NO'}, {node.tap or 'KC_NO'}, {first}, {len(node.children)}, {flags} }},")
+    out.append("};")
+
+    notes = ambiguities(sequences)
+    if notes:
+        out.append("")
+        out.append("// These sequences are prefixes of longer ones and resolve on LEADER_TIMEOUT.")
+        for short, longer in notes:
+            out.append(f"//   {' '.join(short)} waits for LEADER_TIMEOUT, {' '.join(longer)} extends it")
+    out.append("")
+    return "\n".join(out), notes
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("layout_dir")
+    parser.add_argument("--check", action="store_true", help="fail if leader.inc does not match leader.json")
+    args = parser.parse_args()
+
+    json_path = os.path.join(args.layout_dir, "leader.json")
+    inc_path = os.path.join(args.layout_dir, "leader.inc")
+    try:
+        text, notes = render(load_json(json_path))
+    except (OSError, ValueError) as e:
+        sys.exit(f"gen_leader: {e}")
+
+    for short, longer in notes:
+        print(f"gen_leader: ambiguous prefix {' '.join(short)}: {' '.join(longer)} extends it, so it waits for LEADER_TIMEOUT", file=sys.stderr)
+
+    if args.check:
+        try:
+            with open(inc_path) as f:
+                current = f.read()
+        except OSError:
+            current = None
+        if current != text:
+            sys.exit(f"gen_leader: {inc_path} is out of date, run tools/leader/gen_leader.py {args.layout_dir}")
+        return
+
+    with open(inc_path, "w") as f:
+        f.write(text)
+
+
+if __name__ == "__main__":
+    main()
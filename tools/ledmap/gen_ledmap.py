@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+"""Generate the sparse per-layer LED colour table for a layout.
+
+The source is <layout>/ledmap.json:
+
+    {
+      "layers": {
+        "0": [[<led>, <h>, <s>, <v>], ...],
+        ...
+      }
+    }
+
+Only lit LEDs are listed; every other LED on a listed layer is off. Layers
+missing from the file have no colour map, so the active RGB effect shows
+through on them. The output, <layout>/ledmap.inc, is what set_layer_color
+decodes on the keyboard.
+
+Usage:
+    gen_ledmap.py <layout_dir>                  write ledmap.inc
+    gen_ledmap.py --check <layout_dir>          fail if ledmap.inc is stale
+    gen_ledmap.py --import-c <file> <layout_dir>
+        convert a dense Oryx `ledmap[][RGB_MATRIX_LED_COUNT][3]` table found
+        in <file> into ledmap.json, then write ledmap.inc
+"""
+
+import argparse
+import json
+import os
+import re
+import sys
+
+LED_COUNT = 52
+MAX_LAYERS = 16
+
+
+def load_json(path):
+    with open(path) as f:
+        data = json.load(f)
+    layers = {}
+    for name, entries in data.get("layers", {}).items():
+        layer = int(name)
+        if not 0 <= layer < MAX_LAYERS:
+            raise ValueError(f"{path}: layer {layer} out of range")
+        seen = set()
+        lit = []
+        for entry in entries:
+            if len(entry) != 4 or not all(isinstance(x, int) and 0 <= x <= 255 for x in entry):
+                raise ValueError(f"{path}: layer {layer}: bad entry {entry}, expected [led, h, s, v]")
+            led = entry[0]
+            if led >= LED_COUNT:
+                raise ValueError(f"{path}: layer {layer}: led {led} out of range")
+            if led in seen:
+                raise ValueError(f"{path}: layer {layer}: led {led} listed twice")
+            seen.add(led)
+            if any(entry[1:]):
+                lit.append(tuple(entry))
+        layers[layer] = sorted(lit)
+    return layers
+
+
+def import_c(path):
+    """Parse a dense `ledmap[][RGB_MATRIX_LED_COUNT][3]` initialiser."""
+    with open(path) as f:
+        src = f.read()
+    m = re.search(r"ledmap\s*\[\s*\]\s*\[\s*RGB_MATRIX_LED_COUNT\s*\]\s*\[\s*3\s*\]\s*=\s*\{", src)
+    if not m:
+        raise ValueError(f"{path}: no ledmap table found")
+    layers = {}
+    for lm in re.finditer(r"\[\s*(\d+)\s*\]\s*=\s*\{((?:\s*\{\s*\d+\s*,\s*\d+\s*,\s*\d+\s*\}\s*,?)*)\s*\}", src[m.end():]):
+        hsv = [tuple(int(x) for x in t) for t in re.findall(r"\{\s*(\d+)\s*,\s*(\d+)\s*,\s*(\d+)\s*\}", lm.group(2))]
+        if len(hsv) != LED_COUNT:
+            raise ValueError(f"{path}: layer {lm.group(1)} has {len(hsv)} LEDs, expected {LED_COUNT}")
+        layers[int(lm.group(1))] = [(led,) + c for led, c in enumerate(hsv) if any(c)]
+    if not layers:
+        raise ValueError(f"{path}: ledmap table is empty")
+    return layers
+
+
+def write_json(path, layers):
+    lines = ["{", '  "layers": {']
+    names = sorted(layers)
+    for i, layer in enumerate(names):
+        entries = ", ".join(f"[{led}, {h}, {s}, {v}]" for led, h, s, v in layers[layer])
+        lines.append(f'    "{layer}": [{entries}]' + ("," if i + 1 < len(names) else ""))
+    lines += ["  }", "}", ""]
+    with open(path, "w") as f:
+        f.write("\n".join(lines))
+
+
+def render(layers):
+    count = max(layers) + 1 if layers else 0
+    mask = sum(1 << layer for layer in layers)
+    out = [
+        "// Generated by tools/ledmap/gen_ledmap.py from ledmap.json. Do not edit.",
+        "#pragma once",
+        "",
+        "typedef struct {",
+        "  uint8_t led;",
+        "  uint8_t h;",
+        "  uint8_t s;",
+        "  uint8_t v;",
+        "} ledmap_entry_t;",
+        "",
+        f"#define LEDMAP_LAYER_COUNT {count}",
+        "",
+        "// Layers that have a colour map; on any other layer the RGB effect shows.",
+        f"#define LEDMAP_LAYERS 0x{mask:04X}",
+        "",
+        "// Lit LEDs only, grouped by layer.",
+        "const ledmap_entry_t PROGMEM ledmap_entries[] = {",
+    ]
+    offsets = [0]
+    for layer in range(count):
+        entries = layers.get(layer, [])
+        if entries:
+            out.append(f"  // layer {layer}")
+            for led, h, s, v in entries:
+                out.append(f"  {{ {led:2d}, {h:3d}, {s:3d}, {v:3d} }},")
+        offsets.append(offsets[-1] + len(entries))
+    if offsets[-1] == 0:
+        out.append("  { 0, 0, 0, 0 },")
+    out += [
+        "};",
+        "",
+        "// Layer n owns ledmap_entries[ledmap_offsets[n]] up to ledmap_offsets[n + 1].",
+        f"const uint16_t PROGMEM ledmap_offsets[LEDMAP_LAYER_COUNT + 1] = {{ {', '.join(map(str, offsets))} }};",
+        "",
+    ]
+    return "\n".join(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("layout_dir")
+    parser.add_argument("--check", action="store_true", help="fail if ledmap.inc does not match ledmap.json")
+    parser.add_argument("--import-c", metavar="FILE", help="create ledmap.json from a dense C ledmap table")
+    args = parser.parse_args()
+
+    json_path = os.path.join(args.layout_dir, "ledmap.json")
+    inc_path = os.path.join(args.layout_dir, "ledmap.inc")
+    try:
+        if args.import_c:
+            write_json(json_path, import_c(args.import_c))
+        text = render(load_json(json_path))
+    except (OSError, ValueError) as e:
+        sys.exit(f"gen_ledmap: {e}")
+
+    if args.check:
+        try:
+            with open(inc_path) as f:
+                current = f.read()
+        except OSError:
+            current = None
+        if current != text:
+            sys.exit(f"gen_ledmap: {inc_path} is out of date, run tools/ledmap/gen_ledmap.py {args.layout_dir}")
+        return
+
+    with open(inc_path, "w") as f:
+        f.write(text)
+
+
+if __name__ == "__main__":
+    main()
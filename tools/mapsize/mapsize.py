@@ -0,0 +1,202 @@
+#!/usr/bin/env python3
+"""Attribute flash and RAM of a firmware build to features and functions.
+
+Reads the GNU ld map file that `make zsa/voyager:vrMEr` leaves next to the
+firmware (.build/zsa_voyager_vrMEr.map in the QMK tree) and sorts every input
+section into a feature: combos, leader, key overrides, caps word, repeat key,
+mouse keys, Oryx, the RGB matrix, the layout's own code and so on. Sections
+are matched by the object they come from and, for LTO builds whose objects
+carry no source path, by the symbol they hold.
+
+Flash is code, read-only data and the initial values of .data; RAM is .data
+and .bss. Stacks and the heap are sized by the linker script and not listed.
+
+The layout's own sections (keymap.c with custom_layout.inc, the vrmer_*
+modules) are also listed one symbol each: process_record_user, keymaps,
+ledmap_entries and the rest, largest first.
+
+Usage:
+    mapsize.py <map>                     features, then the layout's symbols
+    mapsize.py <map> --top 40            list more layout symbols
+    mapsize.py <map> --json              machine-readable output
+    mapsize.py <map> --markdown          tables for a CI job summary
+"""
+
+import argparse
+import json
+import re
+import sys
+
+# (feature, object path pattern, symbol pattern), first match wins.
+FEATURES = [
+    ("layout", r"/keymaps/|/keymap\.o$|/vrmer_\w+\.o$", r"^(vrmer_|keymaps$|ledmap_|combo_|key_combos$|leader_(start|end)_user|process_record_user$|pre_process_record_user$|get_tapping_term$|rgb_matrix_indicators_user$|housekeeping_task_user$|keyboard_post_init_user$)"),
+    ("combos", r"process_combo\.o$", r"combo"),
+    ("leader", r"(process_)?leader\.o$", r"leader"),
+    ("key overrides", r"process_key_override\.o$", r"key_override"),
+    ("caps word", r"caps_word\.o$", r"caps_word"),
+    ("repeat key", r"repeat_key\.o$", r"repeat_key|last_keycode|last_mods"),
+    ("mouse keys", r"mousekey\.o$|pointing_device", r"mousekey|mouse_report"),
+    ("oryx", r"oryx", r"oryx|rawhid_state|webhid|pairing"),
+    ("rgb matrix", r"/rgb_matrix/|rgb_matrix\.o$|process_rgb_matrix\.o$|/led/|is31|color\.o$", r"rgb_matrix|is31|g_led_config|hsv_to_rgb|led_"),
+    ("tap-hold", r"action_tapping\.o$", r"tapping|waiting_buffer"),
+    ("raw hid", r"raw_hid", r"raw_hid"),
+    ("usb", r"/protocol/|usb_|/usb", r"usb|hid_|send_"),
+    ("chibios", r"/chibios/|/ChibiOS|/os/", r"^(ch[A-Z]|_port|_pal|_stm32|hal|Vector|_unhandled|__early|__late|_crt|__core)"),
+    ("libc", r"lib(c|gcc|m|_nano|nosys)[^/]*\.a|/libc", r"^(mem|str|__aeabi|__udiv|__div|__mod|_printf|printf|sprintf|__errno)"),
+    ("quantum core", r"/quantum/|/tmk_core/|/platforms/|/drivers/", r""),
+    ("keyboard", r"/keyboards/", r""),
+]
+
+FLASH_PREFIXES = (".text", ".rodata", ".vectors", ".ARM", ".glue", ".init", ".fini",
+                  ".ctors", ".dtors", ".preinit_array", ".init_array", ".fini_array")
+DATA_PREFIXES = (".data", ".ram0_init", ".ram1_init", ".ram2_init", ".ram3_init", ".ram4_init")
+BSS_PREFIXES = (".bss", "COMMON", ".ram0", ".ram1", ".ram2", ".ram3", ".ram4", ".noinit")
+
+SECTION_RE = re.compile(r"^ (\S+)(?:\s+(0x[0-9a-fA-F]+)\s+(0x[0-9a-fA-F]+)\s+(.*))?$")
+ADDR_RE = re.compile(r"^\s+(0x[0-9a-fA-F]+)\s+(0x[0-9a-fA-F]+)\s+(.*)$")
+SYMBOL_RE = re.compile(r"^\s+0x[0-9a-fA-F]+\s+([A-Za-z_]\w*)\s*$")
+
+
+def kind(section):
+    """text (flash only), data (flash and RAM), bss (RAM only) or None."""
+    for prefixes, name in ((DATA_PREFIXES, "data"), (BSS_PREFIXES, "bss"), (FLASH_PREFIXES, "text")):
+        if any(section == p or section.startswith(p + ".") for p in prefixes):
+            return name
+    return None
+
+
+def read_map(path):
+    """Input sections with a size: [(section, kind, size, object, [symbols])]."""
+    with open(path, errors="replace") as f:
+        lines = f.read().splitlines()
+    try:
+        start = next(i for i, l in enumerate(lines) if l.startswith("Linker script and memory map"))
+    except StopIteration:
+        raise ValueError(f"{path}: not a GNU ld map file") from None
+
+    sections = []
+    current = None
+    i = start
+    while i < len(lines):
+        line = lines[i]
+        i += 1
+        if line.startswith("/DISCARD/") or line.startswith(".debug") or line.startswith(".comment"):
+            current = None
+            continue
+        m = SECTION_RE.match(line)
+        if m and not m.group(1).startswith("*"):
+            name = m.group(1)
+            if m.group(2) is None:
+                # Long section names put address, size and object on the next line.
+                n = ADDR_RE.match(lines[i]) if i < len(lines) else None
+                if not n:
+                    continue
+                address, size, obj = n.groups()
+                i += 1
+            else:
+                address, size, obj = m.group(2), m.group(3), m.group(4)
+            size = int(size, 16)
+            k = kind(name)
+            current = None
+            if size and k and int(address, 16):
+                current = [name, k, size, obj.strip(), []]
+                sections.append(current)
+            continue
+        m = SYMBOL_RE.match(line)
+        if m and current is not None:
+            current[4].append(m.group(1))
+    return sections
+
+
+def symbol_of(section, symbols):
+    """Name of what an input section holds."""
+    if symbols:
+        return symbols[0]
+    for prefix in (".text.", ".rodata.", ".data.", ".bss.", ".ram0_init.", ".ram0."):
+        if section.startswith(prefix):
+            return section[len(prefix):]
+    return section
+
+
+def feature_of(obj, symbol):
+    for name, path_re, symbol_re in FEATURES:
+        if re.search(path_re, obj):
+            return name
+    # LTO partitions and unknown paths: go by the symbol.
+    for name, path_re, symbol_re in FEATURES:
+        if symbol_re and re.search(symbol_re, symbol):
+            return name
+    return "other"
+
+
+def attribute(sections):
+    features, layout = {}, {}
+    for name, k, size, obj, symbols in sections:
+        symbol = symbol_of(name, symbols)
+        feature = feature_of(obj, symbol)
+        flash = size if k in ("text", "data") else 0
+        ram = size if k in ("data", "bss") else 0
+        f = features.setdefault(feature, {"flash": 0, "ram": 0})
+        f["flash"] += flash
+        f["ram"] += ram
+        if feature == "layout":
+            s = layout.setdefault(symbol, {"flash": 0, "ram": 0, "object": obj.rsplit("/", 1)[-1]})
+            s["flash"] += flash
+            s["ram"] += ram
+    return features, layout
+
+
+def by_size(table):
+    return sorted(table.items(), key=lambda item: (-item[1]["flash"], -item[1]["ram"], item[0]))
+
+
+def print_text(features, layout, top):
+    total_flash = sum(f["flash"] for f in features.values()) or 1
+    total_ram = sum(f["ram"] for f in features.values()) or 1
+    print(f"{'feature':<16}{'flash':>9}{'%':>7}{'ram':>9}{'%':>7}")
+    for name, f in by_size(features):
+        print(f"{name:<16}{f['flash']:>9}{100 * f['flash'] / total_flash:>6.1f}%{f['ram']:>9}{100 * f['ram'] / total_ram:>6.1f}%")
+    print(f"{'total':<16}{total_flash:>9}{'':>7}{total_ram:>9}")
+    print()
+    print(f"{'layout symbol':<36}{'flash':>8}{'ram':>8}  object")
+    for name, s in by_size(layout)[:top]:
+        print(f"{name:<36}{s['flash']:>8}{s['ram']:>8}  {s['object']}")
+
+
+def print_markdown(features, layout, top):
+    print("| feature | flash | ram |")
+    print("|---|---:|---:|")
+    for name, f in by_size(features):
+        print(f"| {name} | {f['flash']} | {f['ram']} |")
+    print(f"| **total** | **{sum(f['flash'] for f in features.values())}** | **{sum(f['ram'] for f in features.values())}** |")
+    print()
+    print("| layout symbol | flash | ram | object |")
+    print("|---|---:|---:|---|")
+    for name, s in by_size(layout)[:top]:
+        print(f"| `{name}` | {s['flash']} | {s['ram']} | {s['object']} |")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("map")
+    parser.add_argument("--top", type=int, default=20, help="layout symbols to list (default 20)")
+    output = parser.add_mutually_exclusive_group()
+    output.add_argument("--json", action="store_true", help="print JSON")
+    output.add_argument("--markdown", action="store_true", help="print Markdown tables")
+    args = parser.parse_args()
+
+    try:
+        features, layout = attribute(read_map(args.map))
+    except (OSError, ValueError) as e:
+        sys.exit(f"mapsize: {e}")
+    if args.json:
+        json.dump({"features": dict(by_size(features)), "layout": dict(by_size(layout))}, sys.stdout, indent=2)
+        print()
+    elif args.markdown:
+        print_markdown(features, layout, args.top)
+    else:
+        print_text(features, layout, args.top)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,687 @@
+#!/usr/bin/env python3
+"""Search for better key placements on a layout, scored against a corpus.
+
+The layout is read from <layout>/custom_layout.inc (or keymap.c): every
+`[NAME] = LAYOUT_voyager(...)` block, mapped onto the 52-slot model of
+vrMEr/visualization-method.md. Slot geometry is SLOT_COORDS from
+<layout>/layout-visualization.html (vrMEr's is used if the layout has none).
+Keycodes are turned into characters through the layout's i18n.h as a German
+host types them.
+
+A placement is scored on the corpus bigrams as a weighted sum of:
+
+    effort   distance of each key from its finger's home key
+    sfb      same finger, different key, twice in a row (per key of travel)
+    alt      hand alternation (a bonus, so it lowers the score)
+    row      same-hand jumps of more than one row
+    layer    keys reached through a layer key (OSL/LT/MO/TT on the base layer)
+
+Only character keys on the chosen layers move; a mod-tap or layer-tap keeps
+its hold action and only its tap key changes, so it only takes keys that can
+be tapped from it. Characters missing from the layout are skipped.
+
+Per-OS overlays (vrmer_overlay_t tables bound to a stored layer in
+vrmer_layers[]) follow the stored layer: an overlay entry that types the same
+character with another hold action, like MT(MOD_LCTL, KC_E) over
+MT(MOD_LGUI, KC_E), gets the same new tap key. A slot where an overlay puts a
+different key stays in place, so no OS loses or doubles a character.
+
+The search runs one simulated annealing chain per worker process. After each
+round the best distinct placements are kept and the next round starts from
+them and from cycle crossovers between them. The output ranks the best
+placements as slot edits against the current layout; --emit prints the
+changed layers in LAYOUT_voyager(...) form and the changed overlay tables for
+custom_layout.inc.
+
+Corpus files are UTF-8 text, folded to lower case, or simulator traces
+(tools/sim, `<ms> down kNN`), whose presses are typed on the current layout.
+
+Usage:
+    optimize.py <layout_dir> --corpus FILE [FILE...]
+        [--layer NAME]...          layers to rearrange (default: the first)
+        [--jobs N] [--rounds N] [--steps N] [--seed N]
+        [--pin KEYCODE]...         keep a key in place (default: space, enter)
+        [--weight NAME=VALUE]...   override a scoring weight
+        [--top N] [--emit] [--json]
+"""
+
+import argparse
+import json
+import math
+import multiprocessing
+import os
+import random
+import re
+import sys
+
+SLOT_COUNT = 52
+
+# LAYOUT_voyager argument order, as listed in visualization-method.md.
+LAYOUT_ORDER = ([*range(0, 6), *range(26, 32), *range(6, 12), *range(32, 38),
+                 *range(12, 18), *range(38, 44), *range(18, 24), *range(44, 50),
+                 24, 25, 50, 51])
+
+THUMBS = {24, 25, 50, 51}
+
+# Finger per SLOT_COORDS column, and each finger's home slot.
+FINGERS = {0: "lp", 1: "lp", 2: "lr", 3: "lm", 4: "li", 5: "li",
+           10: "ri", 11: "ri", 12: "rm", 13: "rr", 14: "rp", 15: "rp"}
+HOME = {"lp": 7, "lr": 8, "lm": 9, "li": 10, "lt": 25,
+        "ri": 33, "rm": 34, "rr": 35, "rp": 36, "rt": 50}
+
+WEIGHTS = {"effort": 1.0, "sfb": 4.0, "alt": 0.5, "row": 1.5, "layer": 2.0}
+
+# What a German host types for each HID keycode: plain, Shift, AltGr.
+DE_PLAIN = {
+    **{f"KC_{c.upper()}": c for c in "abcdefghijklmnopqrstuvwx"},
+    "KC_Y": "z", "KC_Z": "y",
+    **{f"KC_{d}": d for d in "1234567890"},
+    "KC_SPACE": " ", "KC_SPC": " ", "KC_ENTER": "\n", "KC_ENT": "\n",
+    "KC_DOT": ".", "KC_COMM": ",", "KC_COMMA": ",", "KC_SLSH": "-",
+    "KC_MINS": "ß", "KC_LBRC": "ü", "KC_QUOT": "ä", "KC_SCLN": "ö",
+    "KC_RBRC": "+", "KC_NUHS": "#", "KC_NUBS": "<", "KC_GRV": "^",
+}
+DE_SHIFT = {
+    "KC_1": "!", "KC_2": '"', "KC_3": "§", "KC_4": "$", "KC_5": "%",
+    "KC_6": "&", "KC_7": "/", "KC_8": "(", "KC_9": ")", "KC_0": "=",
+    "KC_MINS": "?", "KC_RBRC": "*", "KC_SLSH": "_", "KC_DOT": ":",
+    "KC_COMM": ";", "KC_NUHS": "'", "KC_NUBS": ">", "KC_EQL": "`",
+}
+DE_ALTGR = {
+    "KC_8": "[", "KC_9": "]", "KC_7": "{", "KC_0": "}", "KC_Q": "@",
+    "KC_MINS": "\\", "KC_NUBS": "|", "KC_RBRC": "~", "KC_E": "€",
+}
+
+
+def norm(expr):
+    return "".join(expr.split())
+
+
+def split_args(body):
+    """Split a macro argument list at top-level commas."""
+    args, depth, cur = [], 0, ""
+    for ch in body:
+        if ch == "(":
+            depth += 1
+        elif ch == ")":
+            depth -= 1
+        if ch == "," and depth == 0:
+            args.append(cur)
+            cur = ""
+        else:
+            cur += ch
+    args.append(cur)
+    return [" ".join(a.split()) for a in args if a.strip()]
+
+
+def strip_comments(src):
+    return re.sub(r"//[^\n]*|/\*.*?\*/", "", src, flags=re.S)
+
+
+# ---------------------------------------------------------------------------
+# Layout
+
+
+class Layout:
+    def __init__(self, layout_dir):
+        self.dir = layout_dir
+        self.layers = {}  # name -> [keycode expression per slot]
+        self.overlays = {}  # table -> (stored layer, {slot: keycode expression})
+        self.defines = {}
+        self.coords = {}
+        self.load_keymap()
+        self.load_overlays()
+        self.load_defines()
+        self.load_coords()
+        self.base = next(iter(self.layers))
+        self.switch = self.find_switches()
+
+    def load_keymap(self):
+        for name in ("custom_layout.inc", "keymap.c"):
+            path = os.path.join(self.dir, name)
+            if not os.path.exists(path):
+                continue
+            with open(path) as f:
+                src = strip_comments(f.read())
+            for m in re.finditer(r"\[\s*(\w+)\s*\]\s*=\s*LAYOUT_voyager\s*\(", src):
+                depth, i = 1, m.end()
+                while depth:
+                    depth += {"(": 1, ")": -1}.get(src[i], 0)
+                    i += 1
+                args = split_args(src[m.end():i - 1])
+                if len(args) != SLOT_COUNT:
+                    raise ValueError(f"{path}: layer {m.group(1)} has {len(args)} keys, expected {SLOT_COUNT}")
+                keys = [None] * SLOT_COUNT
+                for slot, kc in zip(LAYOUT_ORDER, args):
+                    keys[slot] = kc
+                self.layers[m.group(1)] = keys
+            if self.layers:
+                self.source = path
+                return
+        raise ValueError(f"{self.dir}: no LAYOUT_voyager layers found")
+
+    def load_overlays(self):
+        with open(self.source) as f:
+            src = strip_comments(f.read())
+        tables = {}
+        for m in re.finditer(r"vrmer_overlay_t\s+PROGMEM\s+(\w+)\s*\[\s*\]\s*=\s*\{(.*?)\};", src, re.S):
+            tables[m.group(1)] = {int(e.group(1)): " ".join(e.group(2).split())
+                                  for e in re.finditer(r"\{\s*VOYAGER_SLOT\((\d+)\)\s*,\s*([^{}]+?)\s*\}", m.group(2))}
+        for m in re.finditer(r"\{\s*(\w+)\s*,\s*ARRAY_SIZE\((\w+)\)\s*,\s*\2\s*\}", src):
+            if m.group(1) in self.layers and m.group(2) in tables:
+                self.overlays[m.group(2)] = (m.group(1), tables[m.group(2)])
+
+    def overlaid(self, layer, slot):
+        """Overlay tables with an entry for a slot of a stored layer."""
+        return [name for name, (stored, table) in self.overlays.items() if stored == layer and slot in table]
+
+    def follows_overlays(self, layer, slot):
+        """Whether every overlay entry on the slot types the stored key's character."""
+        c = self.char(self.layers[layer][slot])
+        return all(self.char(self.overlays[name][1][slot]) == c for name in self.overlaid(layer, slot))
+
+    def load_defines(self):
+        path = os.path.join(self.dir, "i18n.h")
+        if os.path.exists(path):
+            with open(path) as f:
+                for m in re.finditer(r"^#define\s+(\w+)\s+(.+)$", f.read(), re.M):
+                    self.defines[m.group(1)] = norm(m.group(2))
+
+    def load_coords(self):
+        for path in (os.path.join(self.dir, "layout-visualization.html"),
+                     os.path.join(os.path.dirname(__file__), "..", "..", "vrMEr", "layout-visualization.html")):
+            if not os.path.exists(path):
+                continue
+            with open(path) as f:
+                src = f.read()
+            for m in re.finditer(r"k(\d\d)\s*:\s*\{\s*x\s*:\s*([\d.]+)\s*,\s*y\s*:\s*([\d.]+)\s*\}", src):
+                self.coords[int(m.group(1))] = (float(m.group(2)), float(m.group(3)))
+            if len(self.coords) == SLOT_COUNT:
+                return
+        raise ValueError("no SLOT_COORDS with 52 slots found")
+
+    def expand(self, expr, depth=0):
+        """Replace i18n.h aliases until only QMK keycodes are left."""
+        if depth > 8:
+            return expr
+        out = re.sub(r"\b(DE_\w+|KC_MAC_\w+)\b",
+                     lambda m: self.defines.get(m.group(1), m.group(1)), expr)
+        return out if out == expr else self.expand(out, depth + 1)
+
+    def tap(self, kc):
+        """The tapped part of a keycode: the key of a mod-tap or layer-tap."""
+        m = re.fullmatch(r"(MT|LT)\((\w+),(.+)\)", norm(kc))
+        return m.group(3) if m else norm(kc)
+
+    def char(self, kc):
+        expr = self.expand(self.tap(kc))
+        m = re.fullmatch(r"(S|LSFT|ALGR|RALT)\((KC_\w+)\)", expr)
+        if m:
+            table = DE_SHIFT if m.group(1) in ("S", "LSFT") else DE_ALTGR
+            return table.get(m.group(2))
+        return DE_PLAIN.get(expr)
+
+    def is_basic(self, kc):
+        return re.fullmatch(r"KC_\w+", self.expand(norm(kc))) is not None
+
+    def needs_basic(self, kc):
+        return re.fullmatch(r"(MT|LT)\(.+\)", norm(kc)) is not None
+
+    def replace_tap(self, kc, new_tap):
+        m = re.fullmatch(r"(MT|LT)\((\w+),(.+)\)", norm(kc))
+        return f"{m.group(1)}({m.group(2)}, {new_tap})" if m else new_tap
+
+    def find_switches(self):
+        """Base-layer slot that reaches each layer."""
+        def key(name):
+            name = re.sub(r"^(LAYER_|KEYMAP_)", "", name)
+            return re.sub(r"^(MAC|WIN)_", "", name)
+
+        by_key = {key(n): n for n in self.layers}
+        switch = {}
+        for slot, kc in enumerate(self.layers[self.base]):
+            m = re.fullmatch(r"(OSL|MO|TT|LT)\((\w+)(,.*)?\)", norm(kc))
+            if m:
+                target = by_key.get(key(m.group(2))) or self.layers.get(m.group(2)) and m.group(2)
+                if target and target != self.base:
+                    switch.setdefault(target, slot)
+        return switch
+
+    def finger(self, slot):
+        x, _ = self.coords[slot]
+        if slot in THUMBS:
+            return "lt" if x < 8 else "rt"
+        return FINGERS[int(x)]
+
+
+# ---------------------------------------------------------------------------
+# Corpus
+
+
+def read_corpus(paths, layout):
+    """Return unigram and bigram counts over the characters the layout has."""
+    chars = {layout.char(kc) for keys in layout.layers.values() for kc in keys} - {None}
+    uni, bi = {}, {}
+    for path in paths:
+        with open(path, encoding="utf-8", errors="replace") as f:
+            text = f.read()
+        if path.endswith(".trace"):
+            text = type_trace(text, layout)
+        prev = None
+        for c in text.lower():
+            if c not in chars:
+                prev = None
+                continue
+            uni[c] = uni.get(c, 0) + 1
+            if prev is not None:
+                bi[(prev, c)] = bi.get((prev, c), 0) + 1
+            prev = c
+    if not uni:
+        raise ValueError("the corpus has no characters that are on the layout")
+    return uni, bi
+
+
+def type_trace(text, layout):
+    """Characters produced by the presses of a simulator trace, following
+    one-shot layer keys on the base layer."""
+    out, layer = [], None
+    for m in re.finditer(r"^\s*\d+\s+down\s+k(\d\d)\s*$", text, re.M):
+        slot = int(m.group(1))
+        kc = layout.layers[layer or layout.base][slot]
+        target = next((name for name, s in layout.switch.items() if s == slot), None)
+        if layer is None and target and norm(kc).startswith("OSL("):
+            layer = target
+            continue
+        c = layout.char(kc)
+        out.append(c if c else "\0")
+        layer = None
+    return "".join(out)
+
+
+# ---------------------------------------------------------------------------
+# Scoring
+
+
+class Model:
+    """Everything a worker needs to score placements; sent once per process."""
+
+    def __init__(self, layout, layers, pinned, uni, bi, weights):
+        self.weights = weights
+        self.uni = uni
+        self.bi = bi
+        self.base = layout.base
+        self.switch = layout.switch
+        self.layer_order = list(layout.layers)
+        self.finger = {s: layout.finger(s) for s in range(SLOT_COUNT)}
+        self.coords = layout.coords
+        self.effort = {s: self.dist(s, HOME[self.finger[s]]) for s in range(SLOT_COUNT)}
+
+        # Fixed keys: every character key outside the movable positions.
+        self.positions = []  # (layer, slot) of the movable keys
+        self.fixed = {}      # char -> [(layer, slot)]
+        movable_layers = set(layers)
+        for name, keys in layout.layers.items():
+            for slot, kc in enumerate(keys):
+                c = layout.char(kc)
+                if c is None:
+                    continue
+                if name in movable_layers and c in uni and c not in pinned and layout.follows_overlays(name, slot):
+                    self.positions.append((name, slot))
+                else:
+                    self.fixed.setdefault(c, []).append((name, slot))
+        # Positions that only take keys a mod-tap/layer-tap can send.
+        self.basic_only = [layout.needs_basic(layout.layers[l][s]) for l, s in self.positions]
+
+        # Characters with a single key, whose keystrokes follow it directly.
+        count = {}
+        for c in [*(layout.char(layout.layers[l][s]) for l, s in self.positions)]:
+            count[c] = count.get(c, 0) + 1
+        self.single = {c for c, n in count.items() if n == 1 and c not in self.fixed}
+
+        self.pairs_of = {}
+        for (a, b), n in bi.items():
+            self.pairs_of.setdefault(a, set()).add((a, b))
+            self.pairs_of.setdefault(b, set()).add((a, b))
+
+    def dist(self, a, b):
+        (xa, ya), (xb, yb) = self.coords[a], self.coords[b]
+        return math.hypot(xa - xb, ya - yb)
+
+    def keystrokes(self, place):
+        layer, slot = place
+        if layer == self.base:
+            return (slot,)
+        if layer in self.switch:
+            return (self.switch[layer], slot)
+        return None
+
+    def locate(self, assign):
+        """char -> keystrokes (slots) for a placement."""
+        where = {c: list(v) for c, v in self.fixed.items()}
+        for (layer, slot), c in zip(self.positions, assign):
+            where.setdefault(c, []).append((layer, slot))
+        rank = {name: i for i, name in enumerate(self.layer_order)}
+        seqs = {}
+        for c, places in where.items():
+            best = None
+            for place in sorted(places, key=lambda p: (p[0] != self.base, rank[p[0]])):
+                best = self.keystrokes(place)
+                if best:
+                    break
+            if best:
+                seqs[c] = best
+        return seqs
+
+    def pair(self, a, b):
+        """Cost of pressing slot b right after slot a, split by metric."""
+        if a == b:
+            return 0.0, 0.0, 0.0
+        fa, fb = self.finger[a], self.finger[b]
+        if fa[0] != fb[0]:
+            return 0.0, 1.0, 0.0
+        if fa == fb:
+            return 1.0 + self.dist(a, b), 0.0, 0.0
+        dy = abs(self.coords[a][1] - self.coords[b][1])
+        if fa[1] != "t" and fb[1] != "t" and dy >= 1.5:
+            return 0.0, 0.0, dy
+        return 0.0, 0.0, 0.0
+
+    def char_terms(self, seq):
+        effort = sum(self.effort[s] for s in seq)
+        sfb = alt = row = 0.0
+        for a, b in zip(seq, seq[1:]):
+            s, al, r = self.pair(a, b)
+            sfb, alt, row = sfb + s, alt + al, row + r
+        return effort, sfb, alt, row, len(seq) - 1
+
+    def metrics(self, seqs):
+        m = dict.fromkeys(WEIGHTS, 0.0)
+        for c, n in self.uni.items():
+            if c in seqs:
+                e, s, al, r, l = self.char_terms(seqs[c])
+                m["effort"] += n * e
+                m["sfb"] += n * s
+                m["alt"] += n * al
+                m["row"] += n * r
+                m["layer"] += n * l
+        for (a, b), n in self.bi.items():
+            if a in seqs and b in seqs:
+                s, al, r = self.pair(seqs[a][-1], seqs[b][0])
+                m["sfb"] += n * s
+                m["alt"] += n * al
+                m["row"] += n * r
+        return m
+
+    def score(self, m):
+        w = self.weights
+        return (w["effort"] * m["effort"] + w["sfb"] * m["sfb"] - w["alt"] * m["alt"]
+                + w["row"] * m["row"] + w["layer"] * m["layer"])
+
+    def partial(self, seqs, chars):
+        """Score of the terms that involve any of chars."""
+        w = self.weights
+        total = 0.0
+        for c in chars:
+            if c in seqs:
+                e, s, al, r, l = self.char_terms(seqs[c])
+                total += self.uni[c] * (w["effort"] * e + w["sfb"] * s - w["alt"] * al + w["row"] * r + w["layer"] * l)
+        pairs = set()
+        for c in chars:
+            pairs |= self.pairs_of.get(c, set())
+        for a, b in pairs:
+            if a in seqs and b in seqs:
+                s, al, r = self.pair(seqs[a][-1], seqs[b][0])
+                total += self.bi[(a, b)] * (w["sfb"] * s - w["alt"] * al + w["row"] * r)
+        return total
+
+    def valid(self, assign, basic):
+        return all(basic[c] for c, only in zip(assign, self.basic_only) if only)
+
+
+# ---------------------------------------------------------------------------
+# Search
+
+_model = None
+_basic = None
+
+
+def _init_worker(model, basic):
+    global _model, _basic
+    _model, _basic = model, basic
+
+
+def anneal(task):
+    """One annealing chain; returns (score, placement)."""
+    start, seed, steps = task
+    model, basic = _model, _basic
+    rng = random.Random(seed)
+    assign = list(start)
+    seqs = model.locate(assign)
+    score = model.score(model.metrics(seqs))
+    best, best_assign = score, list(assign)
+    n = len(assign)
+    if n < 2:
+        return best, best_assign
+    t0 = max(score, 1.0) * 0.002
+    for step in range(steps):
+        temp = t0 * (1.0 - step / steps) + 1e-9
+        i, j = rng.randrange(n), rng.randrange(n)
+        x, y = assign[i], assign[j]
+        if x == y:
+            continue
+        if (model.basic_only[i] and not basic[y]) or (model.basic_only[j] and not basic[x]):
+            continue
+        before = model.partial(seqs, (x, y))
+        assign[i], assign[j] = y, x
+        if x in model.single and y in model.single:
+            new_seqs = dict(seqs)
+            new_seqs[x] = model.keystrokes(model.positions[j])
+            new_seqs[y] = model.keystrokes(model.positions[i])
+        else:
+            new_seqs = model.locate(assign)
+        delta = model.partial(new_seqs, (x, y)) - before
+        if delta <= 0 or rng.random() < math.exp(-delta / temp):
+            seqs = new_seqs
+            score += delta
+            if score < best - 1e-9:
+                best, best_assign = score, list(assign)
+        else:
+            assign[i], assign[j] = x, y
+    # Re-score from scratch so rounding in the deltas does not build up.
+    return model.score(model.metrics(model.locate(best_assign))), best_assign
+
+
+def crossover(a, b, rng):
+    """Cycle crossover: every key keeps a position it has in a or in b."""
+    child = [None] * len(a)
+    index_a = {}
+    for i, c in enumerate(a):
+        index_a.setdefault(c, []).append(i)
+    take_a = True
+    for start in range(len(a)):
+        if child[start] is not None:
+            continue
+        i, cycle = start, []
+        while child[i] is None and i not in cycle:
+            cycle.append(i)
+            nxt = [k for k in index_a.get(b[i], []) if k not in cycle and child[k] is None]
+            if not nxt:
+                break
+            i = nxt[0]
+        for k in cycle:
+            child[k] = a[k] if take_a else b[k]
+        take_a = not take_a if rng.random() < 0.9 else take_a
+    if sorted(child) != sorted(a):
+        return list(a)
+    return child
+
+
+def search(model, basic, current, jobs, rounds, steps, keep, seed):
+    rng = random.Random(seed)
+    elites = [(model.score(model.metrics(model.locate(current))), list(current))]
+    with multiprocessing.Pool(jobs, initializer=_init_worker, initargs=(model, basic)) as pool:
+        for r in range(rounds):
+            starts = []
+            for k in range(jobs):
+                parent = elites[k % len(elites)][1]
+                if r and len(elites) > 1 and k % 2:
+                    other = elites[rng.randrange(len(elites))][1]
+                    child = crossover(parent, other, rng)
+                    parent = child if model.valid(child, basic) else parent
+                starts.append((parent, rng.randrange(1 << 30), steps))
+            results = pool.map(anneal, starts)
+            seen, merged = set(), []
+            for s, a in sorted(elites + results, key=lambda e: e[0]):
+                if tuple(a) not in seen:
+                    seen.add(tuple(a))
+                    merged.append((s, a))
+            elites = merged[:keep]
+            print(f"optimize: round {r + 1}/{rounds}, best {elites[0][0]:.0f}", file=sys.stderr)
+    return elites
+
+
+# ---------------------------------------------------------------------------
+# Output
+
+
+def edits(layout, model, current, assign):
+    """Slot edits that turn the current layout into assign, overlay entries
+    included."""
+    tap_kc = {}
+    for (layer, slot), c in zip(model.positions, current):
+        tap_kc.setdefault(c, layout.tap(layout.layers[layer][slot]))
+    out = []
+    for (layer, slot), old_c, new_c in zip(model.positions, current, assign):
+        if old_c != new_c:
+            old = layout.layers[layer][slot]
+            out.append((layer, slot, old, layout.replace_tap(old, tap_kc[new_c])))
+            for name in layout.overlaid(layer, slot):
+                old = layout.overlays[name][1][slot]
+                out.append((name, slot, old, layout.replace_tap(old, tap_kc[new_c])))
+    return out
+
+
+def emit(layout, changes):
+    """The changed layers as LAYOUT_voyager blocks, then the changed overlay
+    tables."""
+    lines = []
+    layers = {}
+    for name in layout.layers:
+        keys = list(layout.layers[name])
+        touched = False
+        for layer, slot, _, new in changes:
+            if layer == name:
+                keys[slot], touched = new, True
+        layers[name] = keys
+        if not touched:
+            continue
+        args = [keys[s] for s in LAYOUT_ORDER]
+        cells = [f"{k + ',':<15} " for k in args[:-1]] + [args[-1]]
+        lines.append(f"  [{name}] = LAYOUT_voyager(")
+        for row in range(4):
+            left = "".join(cells[row * 12:row * 12 + 6])
+            right = "".join(cells[row * 12 + 6:row * 12 + 12])
+            lines.append(f"    {left:<104}{right}".rstrip())
+        left = "".join(cells[48:50])
+        lines.append(f"{' ' * 52}{left:<56}{''.join(cells[50:])}".rstrip())
+        lines.append("  ),")
+    for name, (layer, table) in layout.overlays.items():
+        entries = dict(table)
+        touched = False
+        for changed, slot, _, new in changes:
+            if changed == name:
+                entries[slot], touched = new, True
+        if not touched:
+            continue
+        width = max(len(kc) for kc in entries.values()) + 4
+        if lines:
+            lines.append("")
+        lines.append(f"static const vrmer_overlay_t PROGMEM {name}[] = {{")
+        for slot, kc in entries.items():
+            lead = f"{{ VOYAGER_SLOT({slot}),"
+            lines.append(f"  {lead:<20}{kc + ' },':<{width}}// {layers[layer][slot]}")
+        lines.append("};")
+    return "\n".join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("layout_dir")
+    parser.add_argument("--corpus", nargs="+", required=True, metavar="FILE")
+    parser.add_argument("--layer", action="append", help="layer to rearrange, as named in keymaps[] (repeatable)")
+    parser.add_argument("--pin", action="append", metavar="KEYCODE",
+                        help="keep the keys that type this keycode's character in place (default: KC_SPACE, KC_ENTER)")
+    parser.add_argument("--jobs", type=int, default=os.cpu_count() or 1)
+    parser.add_argument("--rounds", type=int, default=6)
+    parser.add_argument("--steps", type=int, default=20000, help="annealing steps per worker and round")
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--weight", action="append", default=[], metavar="NAME=VALUE")
+    parser.add_argument("--top", type=int, default=5, help="placements to report")
+    parser.add_argument("--emit", action="store_true", help="print the best placement's changed layers")
+    parser.add_argument("--json", action="store_true")
+    args = parser.parse_args()
+
+    weights = dict(WEIGHTS)
+    try:
+        for w in args.weight:
+            name, _, value = w.partition("=")
+            if name not in weights:
+                raise ValueError(f"unknown weight {name}, expected one of {', '.join(weights)}")
+            weights[name] = float(value)
+        layout = Layout(args.layout_dir)
+        layers = args.layer or [layout.base]
+        for name in layers:
+            if name not in layout.layers:
+                raise ValueError(f"no layer {name} in {layout.source}")
+        uni, bi = read_corpus(args.corpus, layout)
+        pinned = set()
+        for kc in args.pin or ["KC_SPACE", "KC_ENTER"]:
+            c = layout.char(kc)
+            if c is None:
+                raise ValueError(f"--pin {kc}: not a character key")
+            pinned.add(c)
+    except (OSError, ValueError) as e:
+        sys.exit(f"optimize: {e}")
+
+    model = Model(layout, layers, pinned, uni, bi, weights)
+    current = [layout.char(layout.layers[l][s]) for l, s in model.positions]
+    basic = {}
+    for (l, s), c in zip(model.positions, current):
+        basic[c] = basic.get(c, True) and layout.is_basic(layout.tap(layout.layers[l][s]))
+
+    base_metrics = model.metrics(model.locate(current))
+    base_score = model.score(base_metrics)
+    elites = search(model, basic, current, max(1, args.jobs), args.rounds, args.steps, args.top, args.seed)
+
+    chars = sum(uni.values())
+    ranked = []
+    for score, assign in elites[:args.top]:
+        ranked.append({
+            "score": round(score, 1),
+            "gain_per_char": round((base_score - score) / chars, 4),
+            "metrics": {k: round(v, 1) for k, v in model.metrics(model.locate(assign)).items()},
+            "edits": [{"layer": l, "slot": f"k{s:02d}", "from": old, "to": new}
+                      for l, s, old, new in edits(layout, model, current, assign)],
+        })
+
+    if args.json:
+        json.dump({"current": {"score": round(base_score, 1),
+                               "metrics": {k: round(v, 1) for k, v in base_metrics.items()}},
+                   "placements": ranked}, sys.stdout, indent=2, ensure_ascii=False)
+        print()
+    else:
+        print(f"corpus: {chars} characters, {len(bi)} distinct bigrams; {len(model.positions)} movable keys on {', '.join(layers)}")
+        print(f"current: score {base_score:.0f} ({base_score / chars:.3f} per character)  " + "  ".join(f"{k} {v / chars:.3f}" for k, v in base_metrics.items()) )
+        for rank, p in enumerate(ranked, 1):
+            print(f"\n#{rank}: score {p['score']:.0f} ({p['gain_per_char']:+.3f} per character)  "
+                  + "  ".join(f"{k} {v / chars:.3f}" for k, v in p["metrics"].items()))
+            for e in p["edits"]:
+                print(f"  {e['layer']:<16} {e['slot']}  {e['from']} -> {e['to']}")
+    if args.emit and ranked:
+        best = elites[0][1]
+        print()
+        print(emit(layout, edits(layout, model, current, best)))
+
+
+if __name__ == "__main__":
+    main()
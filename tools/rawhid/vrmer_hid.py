@@ -0,0 +1,494 @@
+#!/usr/bin/env python3
+"""Talk to the vendor raw HID commands of the vrMEr layout.
+
+The firmware answers a handful of commands next to Oryx's own protocol (see
+vrMEr/vrmer_rawhid.h for the wire format). This tool finds the keyboard's raw
+HID interface under /dev/hidraw*, sends one command and decodes the reply.
+It needs read/write access to the hidraw node, e.g. through the udev rule
+Keymapp installs, and nothing beyond the Python standard library.
+
+Usage:
+    vrmer_hid.py latency                 print both latency histograms
+    vrmer_hid.py latency --reset         print, then clear them
+    vrmer_hid.py latency --json          machine-readable output
+    vrmer_hid.py usage                   per-key counters as CSV, k00..k51
+    vrmer_hid.py usage --json            the same as JSON
+    vrmer_hid.py usage --reset           print, then clear them
+    vrmer_hid.py looptime                time per main-loop section
+    vrmer_hid.py looptime --reset        print, then clear it
+    vrmer_hid.py looptime --json         machine-readable output
+    vrmer_hid.py debounce                bounces dropped per key
+    vrmer_hid.py debounce --reset        print, then clear them
+    vrmer_hid.py override                runtime overrides in effect
+    vrmer_hid.py override --all          every term and chord, with defaults
+    vrmer_hid.py override term balanced home_row 220
+    vrmer_hid.py override chord os_redo win 'LCTL(LSFT(KC_Z))'
+    vrmer_hid.py override colour 1 27 0 255 200
+    vrmer_hid.py override term balanced home_row default
+    vrmer_hid.py override reset          back to the compiled-in values
+    vrmer_hid.py --device /dev/hidraw3 latency
+"""
+
+import argparse
+import csv
+import glob
+import json
+import os
+import select
+import struct
+import sys
+
+RAW_EPSIZE = 32
+
+# QMK's raw HID interface: usage page 0xFF60, usage 0x61.
+RAW_USAGE = bytes([0x06, 0x60, 0xFF, 0x09, 0x61])
+
+ZSA_VENDOR_ID = 0x3297
+
+CMD_LATENCY_READ = 0xD0
+CMD_LATENCY_RESET = 0xD1
+CMD_USAGE_READ = 0xD2
+CMD_USAGE_RESET = 0xD3
+CMD_LOOPTIME_READ = 0xD4
+CMD_LOOPTIME_RESET = 0xD5
+CMD_OVERRIDES_READ = 0xDA
+CMD_OVERRIDES_WRITE = 0xDB
+CMD_OVERRIDES_RESET = 0xDC
+CMD_OVERRIDES_SAVE = 0xDD
+CMD_DEBOUNCE_READ = 0xDE
+CMD_DEBOUNCE_RESET = 0xDF
+
+STATUS_OK = 0
+STATUS_NAMES = {1: "bad argument", 2: "no space left"}
+
+LATENCY_CLASSES = ("immediate", "deferred")
+
+# vrmer_looptime_section in vrMEr/vrmer_looptime.h.
+LOOPTIME_SECTIONS = ("loop", "matrix", "combo", "leader", "key_override",
+                     "rgb_indicators", "oryx", "i2c", "i2c_failed")
+
+# The 52-slot model of vrMEr/visualization-method.md.
+SLOT_COUNT = 52
+
+# vrmer_layer_names in vrMEr/custom_layout.inc.
+LAYER_NAMES = ("mac_base", "win_base", "symbols", "movement", "numbers",
+               "config", "function", "mac_shortcuts", "win_shortcuts")
+
+# vrmer_override_kind and vrmer_override_term in vrMEr/vrmer_overrides.h.
+OVERRIDE_TERM, OVERRIDE_SHORTCUT, OVERRIDE_COLOUR = range(3)
+TERM_NAMES = ("home_row", "thumb", "other")
+OVERRIDE_NONE = 0xFFFF
+
+# vrmer_profiles in vrMEr/vrmer_profile.h.
+PROFILE_NAMES = ("balanced", "low_latency", "quiet")
+
+# vrmer_custom_keycodes in vrMEr/custom_layout.inc, from OS_UNDO on; each
+# has a {macOS, Windows} chord.
+SHORTCUT_NAMES = (
+    "os_undo", "os_copy", "os_paste", "os_cut", "os_redo", "os_selectall",
+    "os_home", "os_end", "os_pgup", "os_pgdn", "os_prevword", "os_nextword",
+    "sw_mac", "sw_win", "mc_spotlight", "mc_app_switch", "mc_mission_ctl",
+    "mc_force_quit", "mc_screenshot", "mc_screenshot_clip", "mc_lock_screen",
+    "mc_emoji", "mc_hide_app", "fndr_new_window", "fndr_new_tab",
+    "fndr_duplicate", "fndr_get_info", "fndr_rename", "as_focus_left",
+    "as_focus_down", "as_focus_up", "as_focus_right", "as_move_left",
+    "as_move_down", "as_move_up", "as_move_right", "as_workspace_1",
+    "as_workspace_2", "as_workspace_3", "as_workspace_4", "as_full_screen",
+    "as_float_toggle", "wn_task_view", "wn_app_switch", "wn_lock", "wn_emoji",
+    "wn_settings", "wn_explorer", "wn_run", "wn_snap_left", "wn_snap_right",
+    "wn_vdesk_left", "wn_vdesk_right", "wn_vdesk_new", "wn_vdesk_close",
+)
+OS_NAMES = ("mac", "win")
+
+# Modifier wrappers of QMK's basic keycodes, as in quantum/keycodes.h.
+CHORD_MODS = {"LCTL": 0x0100, "LSFT": 0x0200, "LALT": 0x0400, "LGUI": 0x0800,
+              "RCTL": 0x1100, "RSFT": 0x1200, "RALT": 0x1400, "RGUI": 0x1800}
+
+BASIC_KEYS = {f"KC_{chr(ord('A') + i)}": 0x04 + i for i in range(26)}
+BASIC_KEYS.update({f"KC_{(i + 1) % 10}": 0x1E + i for i in range(10)})
+BASIC_KEYS.update({f"KC_F{i + 1}": 0x3A + i for i in range(12)})
+BASIC_KEYS.update({
+    "KC_NO": 0x00, "KC_ENTER": 0x28, "KC_ESCAPE": 0x29, "KC_BSPC": 0x2A, "KC_TAB": 0x2B,
+    "KC_SPACE": 0x2C, "KC_MINUS": 0x2D, "KC_EQUAL": 0x2E, "KC_LBRC": 0x2F, "KC_RBRC": 0x30,
+    "KC_BSLS": 0x31, "KC_SCLN": 0x33, "KC_QUOT": 0x34, "KC_GRAVE": 0x35, "KC_COMMA": 0x36,
+    "KC_DOT": 0x37, "KC_SLASH": 0x38, "KC_HOME": 0x4A, "KC_PGUP": 0x4B, "KC_DEL": 0x4C,
+    "KC_END": 0x4D, "KC_PGDN": 0x4E, "KC_RIGHT": 0x4F, "KC_LEFT": 0x50, "KC_DOWN": 0x51,
+    "KC_UP": 0x52,
+})
+BASIC_NAMES = {v: k for k, v in BASIC_KEYS.items()}
+
+
+class HidError(Exception):
+    pass
+
+
+def find_device():
+    """Return the hidraw node of the first ZSA raw HID interface."""
+    for sys_dir in sorted(glob.glob("/sys/class/hidraw/hidraw*")):
+        try:
+            with open(os.path.join(sys_dir, "device", "report_descriptor"), "rb") as f:
+                descriptor = f.read()
+            with open(os.path.join(sys_dir, "device", "uevent")) as f:
+                uevent = dict(line.rstrip("\n").split("=", 1) for line in f if "=" in line)
+        except OSError:
+            continue
+        # HID_ID=<bus>:<vendor>:<product>, all hex.
+        parts = uevent.get("HID_ID", "").split(":")
+        if len(parts) != 3 or int(parts[1], 16) != ZSA_VENDOR_ID:
+            continue
+        if RAW_USAGE in descriptor:
+            return "/dev/" + os.path.basename(sys_dir)
+    raise HidError("no ZSA raw HID interface found; is the keyboard connected?")
+
+
+class Keyboard:
+    def __init__(self, path, timeout=1.0):
+        self.path = path
+        self.timeout = timeout
+        try:
+            self.fd = os.open(path, os.O_RDWR)
+        except OSError as e:
+            raise HidError(f"{path}: {e.strerror}") from e
+
+    def close(self):
+        os.close(self.fd)
+
+    def command(self, cmd, *args):
+        """Send one command and return the payload after the status byte."""
+        packet = bytes([cmd, *args]).ljust(RAW_EPSIZE, b"\0")
+        # hidraw expects the report id first; the raw HID report has none.
+        os.write(self.fd, b"\0" + packet)
+        while True:
+            ready, _, _ = select.select([self.fd], [], [], self.timeout)
+            if not ready:
+                raise HidError(f"no reply to command 0x{cmd:02x}; does the firmware include vrmer_rawhid.c?")
+            reply = os.read(self.fd, RAW_EPSIZE)
+            # Oryx may interleave its own events while Keymapp is paired.
+            if reply and reply[0] == cmd:
+                break
+        status = reply[1]
+        if status != STATUS_OK:
+            raise HidError(f"command 0x{cmd:02x} failed: {STATUS_NAMES.get(status, status)}")
+        return reply[2:]
+
+
+def bucket_label(i, count):
+    if i == 0:
+        return "0 ms"
+    if i == count - 1:
+        return f">= {1 << (i - 1)} ms"
+    lo, hi = 1 << (i - 1), (1 << i) - 1
+    return f"{lo} ms" if lo == hi else f"{lo}-{hi} ms"
+
+
+def read_latency(kb, cls):
+    payload = kb.command(CMD_LATENCY_READ, cls)
+    count = payload[1]
+    buckets = list(struct.unpack_from(f"<{count}H", payload, 2))
+    max_ms, total_ms = struct.unpack_from("<HI", payload, 2 + 2 * count)
+    return {"buckets": buckets, "max_ms": max_ms, "total_ms": total_ms}
+
+
+def print_latency(name, h):
+    samples = sum(h["buckets"])
+    print(f"{name}: {samples} presses", end="")
+    if samples:
+        print(f", avg {h['total_ms'] / samples:.1f} ms, max {h['max_ms']} ms")
+    else:
+        print()
+    peak = max(h["buckets"]) or 1
+    for i, n in enumerate(h["buckets"]):
+        if n:
+            bar = "#" * max(1, round(40 * n / peak))
+            print(f"  {bucket_label(i, len(h['buckets'])):>10}  {n:6}  {bar}")
+
+
+def cmd_latency(kb, args):
+    hist = {name: read_latency(kb, cls) for cls, name in enumerate(LATENCY_CLASSES)}
+    if args.json:
+        json.dump(hist, sys.stdout, indent=2)
+        print()
+    else:
+        print("matrix scan to HID report queued, per key press")
+        for name, h in hist.items():
+            print_latency(name, h)
+    if args.reset:
+        kb.command(CMD_LATENCY_RESET)
+
+
+def read_usage_table(kb, table):
+    values = []
+    while len(values) < SLOT_COUNT:
+        payload = kb.command(CMD_USAGE_READ, table, len(values))
+        layers, count = payload[0], payload[3]
+        values += struct.unpack_from(f"<{count}H", payload, 4)
+    return layers, values
+
+
+def read_usage(kb):
+    layers, _ = read_usage_table(kb, 0)
+    names = [LAYER_NAMES[i] if i < len(LAYER_NAMES) else f"layer{i}" for i in range(layers)]
+    presses = {name: read_usage_table(kb, i)[1] for i, name in enumerate(names)}
+    taps = read_usage_table(kb, layers)[1]
+    holds = read_usage_table(kb, layers + 1)[1]
+    return {
+        f"k{slot:02d}": {
+            "presses": {name: presses[name][slot] for name in names},
+            "taps": taps[slot],
+            "holds": holds[slot],
+        }
+        for slot in range(SLOT_COUNT)
+    }
+
+
+def cmd_usage(kb, args):
+    usage = read_usage(kb)
+    if args.json:
+        json.dump(usage, sys.stdout, indent=2)
+        print()
+    else:
+        names = list(usage["k00"]["presses"])
+        out = csv.writer(sys.stdout, lineterminator="\n")
+        out.writerow(["slot", *names, "taps", "holds"])
+        for slot, u in usage.items():
+            out.writerow([slot, *u["presses"].values(), u["taps"], u["holds"]])
+    if args.reset:
+        kb.command(CMD_USAGE_RESET)
+
+
+def read_looptime(kb):
+    sections, rate = {}, 0
+    count = 1
+    i = 0
+    while i < count:
+        payload = kb.command(CMD_LOOPTIME_READ, i)
+        count = payload[0]
+        rate, calls, avg_ns, max_ns, share = struct.unpack_from("<HIIIH", payload, 2)
+        name = LOOPTIME_SECTIONS[i] if i < len(LOOPTIME_SECTIONS) else f"section{i}"
+        sections[name] = {"calls": calls, "avg_ns": avg_ns, "max_ns": max_ns, "share_percent": share / 100}
+        i += 1
+    return {"passes_per_second": rate, "sections": sections}
+
+
+def cmd_looptime(kb, args):
+    profile = read_looptime(kb)
+    if args.json:
+        json.dump(profile, sys.stdout, indent=2)
+        print()
+    else:
+        print(f"main loop: {profile['passes_per_second']} passes per second")
+        print(f"  {'section':<16}{'calls':>10}{'avg us':>10}{'max us':>10}{'time %':>8}")
+        for name, s in profile["sections"].items():
+            print(f"  {name:<16}{s['calls']:>10}{s['avg_ns'] / 1000:>10.2f}{s['max_ns'] / 1000:>10.1f}{s['share_percent']:>8.2f}")
+    if args.reset:
+        kb.command(CMD_LOOPTIME_RESET)
+
+
+def read_debounce(kb):
+    bounces = []
+    while len(bounces) < SLOT_COUNT:
+        payload = kb.command(CMD_DEBOUNCE_READ, len(bounces))
+        debounce_ms, total, count = payload[0], struct.unpack_from("<H", payload, 1)[0], payload[4]
+        bounces += payload[5:5 + count]
+    return {"debounce_ms": debounce_ms, "total": total,
+            "bounces": {f"k{slot:02d}": n for slot, n in enumerate(bounces)}}
+
+
+def cmd_debounce(kb, args):
+    d = read_debounce(kb)
+    if args.json:
+        json.dump(d, sys.stdout, indent=2)
+        print()
+    else:
+        print(f"releases held back {d['debounce_ms']} ms; {d['total']} bounces dropped")
+        for slot, n in sorted(d["bounces"].items(), key=lambda item: -item[1]):
+            if n:
+                print(f"  {slot}  {n:4}{'+' if n == 255 else ''}")
+    if args.reset:
+        kb.command(CMD_DEBOUNCE_RESET)
+
+
+def parse_chord(text):
+    """Keycode of 'LGUI(LSFT(KC_Z))', 'KC_HOME' or a number."""
+    text = text.strip().replace(" ", "")
+    try:
+        return int(text, 0)
+    except ValueError:
+        pass
+    mods = 0
+    while "(" in text and text.endswith(")"):
+        name, _, text = text[:-1].partition("(")
+        if name not in CHORD_MODS:
+            raise HidError(f"unknown modifier {name}; one of {', '.join(CHORD_MODS)}")
+        mods |= CHORD_MODS[name]
+    if text not in BASIC_KEYS:
+        raise HidError(f"unknown key {text}; give the keycode as a number instead")
+    return mods | BASIC_KEYS[text]
+
+
+def format_chord(code):
+    key = BASIC_NAMES.get(code & 0xFF, f"0x{code & 0xFF:02x}")
+    mods = code & 0x1F00
+    if code > 0x1FFF or (mods & 0x1000 and not mods & 0x0F00):
+        return f"0x{code:04x}"
+    for name, bits in CHORD_MODS.items():
+        if bits & 0x1000 == mods & 0x1000 and bits & mods & 0x0F00:
+            key = f"{name}({key})"
+    return key
+
+
+def read_override(kb, kind, index):
+    payload = kb.command(CMD_OVERRIDES_READ, kind, index)
+    return payload[2], payload[3], payload[4:]
+
+
+def read_overrides(kb):
+    terms, chords, colours = {}, {}, []
+    count = 1
+    i = 0
+    while i < count:
+        count, set_, value = read_override(kb, OVERRIDE_TERM, i)
+        override, default = struct.unpack_from("<HH", value)
+        name = f"{PROFILE_NAMES[i // 3]}.{TERM_NAMES[i % 3]}"
+        terms[name] = {"override": override if set_ else None, "default": default}
+        i += 1
+    count = 1
+    i = 0
+    while i < count:
+        count, set_, value = read_override(kb, OVERRIDE_SHORTCUT, i)
+        override, default = struct.unpack_from("<HH", value)
+        shortcut = SHORTCUT_NAMES[i // 2] if i // 2 < len(SHORTCUT_NAMES) else f"shortcut{i // 2}"
+        name = f"{shortcut}.{OS_NAMES[i % 2]}"
+        chords[name] = {"override": format_chord(override) if set_ else None, "default": format_chord(default)}
+        i += 1
+    count = 1
+    i = 0
+    while i < count:
+        count, set_, value = read_override(kb, OVERRIDE_COLOUR, i)
+        if set_:
+            layer, led, h, s, v = value[:5]
+            colours.append({"layer": layer, "led": led, "hsv": [h, s, v]})
+        i += 1
+    return {"terms": terms, "chords": chords, "colours": colours}
+
+
+def save_overrides(kb):
+    payload = kb.command(CMD_OVERRIDES_SAVE)
+    copy, seq = payload[0], struct.unpack_from("<H", payload, 1)[0]
+    print(f"saved to EEPROM copy {copy}, write {seq}", file=sys.stderr)
+
+
+def write_override(kb, kind, index, value):
+    """Set an override, or clear it if value is None."""
+    if value is None:
+        kb.command(CMD_OVERRIDES_WRITE, kind, index, 0)
+    else:
+        kb.command(CMD_OVERRIDES_WRITE, kind, index, 1, *value)
+    save_overrides(kb)
+
+
+def lookup(names, name, what):
+    try:
+        return names.index(name.lower())
+    except ValueError:
+        raise HidError(f"unknown {what} {name}; one of {', '.join(names)}") from None
+
+
+def cmd_override(kb, args):
+    if args.action == "term":
+        index = lookup(PROFILE_NAMES, args.profile, "profile") * 3 + lookup(TERM_NAMES, args.term, "term")
+        value = None if args.ms == "default" else int(args.ms)
+        write_override(kb, OVERRIDE_TERM, index, None if value is None else struct.pack("<H", value))
+    elif args.action == "chord":
+        index = lookup(SHORTCUT_NAMES, args.shortcut, "shortcut") * 2 + lookup(OS_NAMES, args.os, "OS")
+        value = None if args.chord == "default" else struct.pack("<H", parse_chord(args.chord))
+        write_override(kb, OVERRIDE_SHORTCUT, index, value)
+    elif args.action == "colour":
+        if args.hsv == ["default"]:
+            kb.command(CMD_OVERRIDES_WRITE, OVERRIDE_COLOUR, args.led, 0, args.layer)
+            save_overrides(kb)
+        elif len(args.hsv) == 3:
+            write_override(kb, OVERRIDE_COLOUR, args.led, [args.layer, *(int(c) & 0xFF for c in args.hsv)])
+        else:
+            raise HidError("colour takes H S V (0-255 each) or 'default'")
+    elif args.action == "reset":
+        kb.command(CMD_OVERRIDES_RESET)
+        save_overrides(kb)
+    else:
+        overrides = read_overrides(kb)
+        if not args.all:
+            overrides["terms"] = {k: v for k, v in overrides["terms"].items() if v["override"] is not None}
+            overrides["chords"] = {k: v for k, v in overrides["chords"].items() if v["override"] is not None}
+        if args.json:
+            json.dump(overrides, sys.stdout, indent=2)
+            print()
+            return
+        for name, t in overrides["terms"].items():
+            value = f"{t['override']} ms" if t["override"] is not None else "-"
+            print(f"term    {name:<30} {value:>10}  (default {t['default']} ms)")
+        for name, c in overrides["chords"].items():
+            print(f"chord   {name:<30} {c['override'] or '-':>10}  (default {c['default']})")
+        for c in overrides["colours"]:
+            name = LAYER_NAMES[c["layer"]] if c["layer"] < len(LAYER_NAMES) else f"layer{c['layer']}"
+            print(f"colour  {name:<18} led {c['led']:<5}  hsv {' '.join(map(str, c['hsv']))}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--device", help="hidraw node (default: first ZSA raw HID interface)")
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    p = sub.add_parser("latency", help="keypress latency histograms")
+    p.add_argument("--reset", action="store_true", help="clear the histograms after reading")
+    p.add_argument("--json", action="store_true", help="print JSON instead of a table")
+    p.set_defaults(func=cmd_latency)
+
+    p = sub.add_parser("usage", help="per-key press and tap/hold counters")
+    p.add_argument("--reset", action="store_true", help="clear the counters after reading")
+    p.add_argument("--json", action="store_true", help="print JSON instead of CSV")
+    p.set_defaults(func=cmd_usage)
+
+    p = sub.add_parser("looptime", help="main-loop time per subsystem (VRMER_LOOPTIME_ENABLE builds)")
+    p.add_argument("--reset", action="store_true", help="clear the profile after reading")
+    p.add_argument("--json", action="store_true", help="print JSON instead of a table")
+    p.set_defaults(func=cmd_looptime)
+
+    p = sub.add_parser("debounce", help="bounces dropped per key by the custom debounce")
+    p.add_argument("--reset", action="store_true", help="clear the counters after reading")
+    p.add_argument("--json", action="store_true", help="print JSON instead of a table")
+    p.set_defaults(func=cmd_debounce)
+
+    p = sub.add_parser("override", help="runtime overrides of terms, chords and colours")
+    p.add_argument("--all", action="store_true", help="list every term and chord, not just overridden ones")
+    p.add_argument("--json", action="store_true", help="print JSON instead of a table")
+    p.set_defaults(func=cmd_override, action=None)
+    actions = p.add_subparsers(dest="action")
+    a = actions.add_parser("term", help="tapping term of a profile, in ms")
+    a.add_argument("profile", help=", ".join(PROFILE_NAMES))
+    a.add_argument("term", help=", ".join(TERM_NAMES))
+    a.add_argument("ms", help="term in ms, or 'default'")
+    a = actions.add_parser("chord", help="chord a shortcut keycode sends")
+    a.add_argument("shortcut", help="e.g. os_undo, wn_lock")
+    a.add_argument("os", help="mac or win")
+    a.add_argument("chord", help="e.g. 'LCTL(LSFT(KC_Z))', a keycode number, or 'default'")
+    a = actions.add_parser("colour", help="colour of one LED on a layer")
+    a.add_argument("layer", type=int)
+    a.add_argument("led", type=int)
+    a.add_argument("hsv", nargs="+", metavar="H S V", help="hue, saturation, value, or 'default'")
+    actions.add_parser("reset", help="clear every override")
+
+    args = parser.parse_args()
+    try:
+        kb = Keyboard(args.device or find_device())
+        try:
+            args.func(kb, args)
+        finally:
+            kb.close()
+    except HidError as e:
+        print(f"vrmer_hid: {e}", file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,246 @@
+#!/usr/bin/env python3
+"""Follow the vrMEr layout's live state stream.
+
+Starts the firmware's telemetry stream (VRMER_HID_TELEMETRY_START, see
+vrMEr/vrmer_telemetry.h), acknowledges every packet so the keyboard keeps
+sending, and decodes the active layer, mods, one-shot and caps word state and
+the held keys. Stopping the daemon (Ctrl-C) stops the stream; if the daemon
+dies instead, the keyboard ends it by itself after two seconds.
+
+By default every state is printed as one line. --json prints JSON lines
+instead. --serve runs a small web server: / is
+vrMEr/layout-visualization.html, which follows the stream from /events
+(server-sent events) and shows the active layer with the held keys marked.
+
+Needs the same hidraw access as vrmer_hid.py and only the standard library.
+
+Usage:
+    vrmer_live.py                        one line per state
+    vrmer_live.py --json                 JSON lines
+    vrmer_live.py --serve 8765           live view on http://localhost:8765/
+    vrmer_live.py --min-gap 20           at most one packet per 20 ms
+    vrmer_live.py --device /dev/hidraw3
+"""
+
+import argparse
+import http.server
+import json
+import os
+import queue
+import select
+import struct
+import sys
+import threading
+import time
+
+from vrmer_hid import LAYER_NAMES, RAW_EPSIZE, SLOT_COUNT, HidError, Keyboard, find_device
+
+CMD_TELEMETRY_START = 0xD6
+CMD_TELEMETRY_STOP = 0xD7
+CMD_TELEMETRY_ACK = 0xD8
+CMD_TELEMETRY_STATE = 0xD9
+
+# Well inside the firmware's VRMER_TELEMETRY_LEASE_MS.
+KEEPALIVE_S = 0.5
+
+MOD_NAMES = ("ctrl", "shift", "alt", "gui")
+FLAG_NAMES = ("caps_word", "leader", "oneshot_layer")
+
+VIEW = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "..", "vrMEr", "layout-visualization.html")
+
+
+def mods(bits):
+    names = [n for i, n in enumerate(MOD_NAMES) if bits & (1 << i)]
+    return names + [f"r{n}" for i, n in enumerate(MOD_NAMES) if bits & (0x10 << i)]
+
+
+def slots(bitmap):
+    return [f"k{n:02d}" for n in range(SLOT_COUNT) if bitmap[n >> 3] & (1 << (n & 7))]
+
+
+def decode(packet):
+    seq = packet[1]
+    ms, layers, default_layers, mod_bits, oneshot, flags = struct.unpack_from("<HHHBBB", packet, 2)
+    held, pressed, events = packet[11:18], packet[18:25], packet[25]
+    active = (layers | default_layers).bit_length() - 1
+    return {
+        "seq": seq,
+        "ms": ms,
+        "layer": active,
+        "layer_name": LAYER_NAMES[active] if 0 <= active < len(LAYER_NAMES) else f"layer{active}",
+        "layers": [i for i in range(16) if layers & (1 << i)],
+        "default_layer": default_layers.bit_length() - 1,
+        "mods": mods(mod_bits),
+        "oneshot_mods": mods(oneshot),
+        "flags": [n for i, n in enumerate(FLAG_NAMES) if flags & (1 << i)],
+        "held": slots(held),
+        "pressed": slots(pressed),
+        "events": events,
+    }
+
+
+def format_state(s):
+    parts = [f"{s['ms']:5} ms", f"{s['layer_name']:<13}"]
+    if s["mods"]:
+        parts.append("mods " + "+".join(s["mods"]))
+    if s["oneshot_mods"]:
+        parts.append("one-shot " + "+".join(s["oneshot_mods"]))
+    parts += s["flags"]
+    parts.append("held " + (" ".join(s["held"]) or "-"))
+    taps = [k for k in s["pressed"] if k not in s["held"]]
+    if taps:
+        parts.append("tapped " + " ".join(taps))
+    return "  ".join(parts)
+
+
+class Stream:
+    """Start the stream and yield decoded states, acknowledging each."""
+
+    def __init__(self, kb, min_gap):
+        self.kb = kb
+        self.min_gap = min_gap
+        self.last_seq = None
+
+    def send(self, *payload):
+        os.write(self.kb.fd, b"\0" + bytes(payload).ljust(RAW_EPSIZE, b"\0"))
+
+    def __iter__(self):
+        payload = self.kb.command(CMD_TELEMETRY_START, self.min_gap)
+        print(f"vrmer_live: streaming, window {payload[0]} packets", file=sys.stderr)
+        keepalive = time.monotonic()
+        while True:
+            ready, _, _ = select.select([self.kb.fd], [], [], KEEPALIVE_S)
+            if ready:
+                packet = os.read(self.kb.fd, RAW_EPSIZE)
+                # Oryx events and stray replies share the interface.
+                if len(packet) == RAW_EPSIZE and packet[0] == CMD_TELEMETRY_STATE:
+                    self.last_seq = packet[1]
+                    self.send(CMD_TELEMETRY_ACK, self.last_seq)
+                    keepalive = time.monotonic()
+                    yield decode(packet)
+            if time.monotonic() - keepalive >= KEEPALIVE_S:
+                if self.last_seq is None:
+                    # Nothing received yet; restarting renews the lease.
+                    self.kb.command(CMD_TELEMETRY_START, self.min_gap)
+                else:
+                    self.send(CMD_TELEMETRY_ACK, self.last_seq)
+                keepalive = time.monotonic()
+
+    def stop(self):
+        self.send(CMD_TELEMETRY_STOP)
+
+
+class Hub:
+    """Hands every state to the connected /events clients."""
+
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.clients = []
+        self.last = None
+
+    def subscribe(self):
+        q = queue.Queue(maxsize=256)
+        with self.lock:
+            self.clients.append(q)
+            if self.last:
+                q.put(self.last)
+        return q
+
+    def unsubscribe(self, q):
+        with self.lock:
+            self.clients.remove(q)
+
+    def publish(self, state):
+        line = json.dumps(state)
+        with self.lock:
+            self.last = line
+            for q in self.clients:
+                try:
+                    q.put_nowait(line)
+                except queue.Full:
+                    pass  # a stalled page only misses states
+
+
+def serve(port, hub):
+    class Handler(http.server.BaseHTTPRequestHandler):
+        def do_GET(self):
+            if self.path in ("/", "/index.html"):
+                try:
+                    with open(VIEW, "rb") as f:
+                        body = f.read()
+                except OSError as e:
+                    self.send_error(500, str(e))
+                    return
+                self.send_response(200)
+                self.send_header("Content-Type", "text/html; charset=utf-8")
+                self.send_header("Content-Length", str(len(body)))
+                self.end_headers()
+                self.wfile.write(body)
+            elif self.path == "/events":
+                self.send_response(200)
+                self.send_header("Content-Type", "text/event-stream")
+                self.send_header("Cache-Control", "no-cache")
+                self.end_headers()
+                q = hub.subscribe()
+                try:
+                    while True:
+                        try:
+                            self.wfile.write(f"data: {q.get(timeout=15)}\n\n".encode())
+                        except queue.Empty:
+                            self.wfile.write(b": keepalive\n\n")
+                        self.wfile.flush()
+                except OSError:
+                    pass
+                finally:
+                    hub.unsubscribe(q)
+            else:
+                self.send_error(404)
+
+        def log_message(self, *args):
+            pass
+
+    server = http.server.ThreadingHTTPServer(("127.0.0.1", port), Handler)
+    server.daemon_threads = True
+    threading.Thread(target=server.serve_forever, daemon=True).start()
+    print(f"vrmer_live: live view on http://localhost:{port}/", file=sys.stderr)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--device", help="hidraw node (default: first ZSA raw HID interface)")
+    parser.add_argument("--min-gap", type=int, default=0, metavar="MS", help="minimum ms between packets, 0-255 (default 0)")
+    parser.add_argument("--json", action="store_true", help="print JSON lines")
+    parser.add_argument("--serve", type=int, metavar="PORT", help="serve the live view on this port")
+    args = parser.parse_args()
+    if not 0 <= args.min_gap <= 255:
+        parser.error("--min-gap must be 0-255")
+
+    hub = Hub()
+    if args.serve:
+        serve(args.serve, hub)
+    try:
+        kb = Keyboard(args.device or find_device())
+        stream = Stream(kb, args.min_gap)
+        try:
+            for state in stream:
+                hub.publish(state)
+                if args.json:
+                    print(json.dumps(state), flush=True)
+                else:
+                    print(format_state(state), flush=True)
+        except KeyboardInterrupt:
+            pass
+        finally:
+            try:
+                stream.stop()
+            except OSError:
+                pass
+            kb.close()
+    except HidError as e:
+        print(f"vrmer_live: {e}", file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
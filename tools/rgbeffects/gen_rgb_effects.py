@@ -0,0 +1,154 @@
+#!/usr/bin/env python3
+"""Generate the RGB matrix effect exclusion list for a layout.
+
+Every RGB matrix effect the keyboard enables costs flash, whether or not the
+layout can ever switch to it. This finds the effects the layout reaches and
+writes <layout>/rgb_effects.h, which config.h includes, with an #undef for
+every other ENABLE_RGB_MATRIX_* flag.
+
+An effect is reached if the layout's sources (keymap.c, custom_layout.inc,
+the other *.c, *.h and *.inc files and config.h) name it as
+RGB_MATRIX_<EFFECT>, e.g. in an rgb_matrix_mode() call or as
+RGB_MATRIX_DEFAULT_MODE, or through a direct-mode key (RGB_M_P, RGB_M_B,
+RGB_M_R, RGB_M_SW). RGB_MATRIX_SOLID_COLOR is always built. A key that steps
+through the effects (RGB_MOD, RGB_RMOD, RM_NEXT, RM_PREV) reaches all of
+them, so then nothing is excluded.
+
+The effect stored in EEPROM, picked in Oryx or with another keyboard's keys
+and restored by rgb_matrix_reload_from_eeprom(), is not visible in the
+sources. Effects that must stay for that reason are declared in any of the
+sources, usually config.h, with one or more lines of
+
+    // rgb-effects: keep SOLID_REACTIVE SPLASH ...
+
+naming effects without the RGB_MATRIX_ prefix.
+
+rgblight_mode(1) and rgb_matrix_mode(1) are the solid colour; any other
+numbered mode cannot be told apart and is an error, name the effect instead.
+
+Usage:
+    gen_rgb_effects.py <layout_dir>            write rgb_effects.h
+    gen_rgb_effects.py --check <layout_dir>    fail if rgb_effects.h is out of date
+"""
+
+import argparse
+import glob
+import os
+import re
+import sys
+
+# quantum/rgb_matrix/animations/rgb_matrix_effects.inc, in mode order.
+EFFECTS = (
+    "ALPHAS_MODS", "GRADIENT_UP_DOWN", "GRADIENT_LEFT_RIGHT", "BREATHING",
+    "BAND_SAT", "BAND_VAL", "BAND_PINWHEEL_SAT", "BAND_PINWHEEL_VAL",
+    "BAND_SPIRAL_SAT", "BAND_SPIRAL_VAL", "CYCLE_ALL", "CYCLE_LEFT_RIGHT",
+    "CYCLE_UP_DOWN", "RAINBOW_MOVING_CHEVRON", "CYCLE_OUT_IN",
+    "CYCLE_OUT_IN_DUAL", "CYCLE_PINWHEEL", "CYCLE_SPIRAL", "DUAL_BEACON",
+    "RAINBOW_BEACON", "RAINBOW_PINWHEELS", "FLOWER_BLOOMING", "RAINDROPS",
+    "JELLYBEAN_RAINDROPS", "HUE_BREATHING", "HUE_PENDULUM", "HUE_WAVE",
+    "PIXEL_FRACTAL", "PIXEL_FLOW", "PIXEL_RAIN", "STARLIGHT",
+    "STARLIGHT_SMOOTH", "STARLIGHT_DUAL_HUE", "STARLIGHT_DUAL_SAT",
+    "RIVERFLOW", "TYPING_HEATMAP", "DIGITAL_RAIN", "SOLID_REACTIVE_SIMPLE",
+    "SOLID_REACTIVE", "SOLID_REACTIVE_WIDE", "SOLID_REACTIVE_MULTIWIDE",
+    "SOLID_REACTIVE_CROSS", "SOLID_REACTIVE_MULTICROSS",
+    "SOLID_REACTIVE_NEXUS", "SOLID_REACTIVE_MULTINEXUS", "SPLASH",
+    "MULTISPLASH", "SOLID_SPLASH", "SOLID_MULTISPLASH",
+)
+
+STEP_KEYS = ("RGB_MOD", "RGB_RMOD", "RM_NEXT", "RM_PREV",
+             "QK_RGB_MATRIX_MODE_NEXT", "QK_RGB_MATRIX_MODE_PREVIOUS")
+
+# What the legacy direct-mode keys select on an RGB matrix keyboard.
+MODE_KEYS = {"RGB_M_B": "BREATHING", "RGB_M_R": "CYCLE_LEFT_RIGHT", "RGB_M_SW": "CYCLE_PINWHEEL"}
+
+OUTPUT = "rgb_effects.h"
+
+EFFECT_RE = re.compile(r"\bRGB_MATRIX_([A-Z_]+)\b")
+KEEP_RE = re.compile(r"^[ \t]*//[ \t]*rgb-effects:[ \t]*keep\b([^\n]*)", re.M)
+NUMBERED_RE = re.compile(r"\b(?:rgblight_mode|rgb_matrix_mode)(?:_noeeprom)?\s*\(\s*(\d+)\s*\)")
+
+
+def strip_comments(text):
+    text = re.sub(r"/\*.*?\*/", " ", text, flags=re.S)
+    return re.sub(r"//[^\n]*", "", text)
+
+
+def sources(layout_dir):
+    paths = []
+    for pattern in ("*.c", "*.h", "*.inc"):
+        paths += glob.glob(os.path.join(layout_dir, pattern))
+    return sorted(p for p in paths if os.path.basename(p) != OUTPUT)
+
+
+def reached(layout_dir):
+    """Effects the layout can switch to and why, or None if it reaches all."""
+    why = {}
+    for path in sources(layout_dir):
+        with open(path) as f:
+            text = f.read()
+        name = os.path.basename(path)
+        for m in KEEP_RE.finditer(text):
+            for effect in m.group(1).split():
+                if effect not in EFFECTS:
+                    raise ValueError(f"{name}: rgb-effects: keep names unknown effect {effect}")
+                why.setdefault(effect, f"kept in {name}")
+        text = strip_comments(text)
+        for key in STEP_KEYS:
+            if re.search(rf"\b{key}\b", text):
+                return None, f"{name} uses {key}"
+        for key, effect in MODE_KEYS.items():
+            if re.search(rf"\b{key}\b", text):
+                why.setdefault(effect, f"{key} in {name}")
+        for m in EFFECT_RE.finditer(text):
+            if m.group(1) in EFFECTS:
+                why.setdefault(m.group(1), f"named in {name}")
+        for m in NUMBERED_RE.finditer(text):
+            if m.group(1) != "1":
+                raise ValueError(f"{name}: mode {m.group(1)} by number; use the RGB_MATRIX_* name")
+    return why, None
+
+
+def generate(layout_dir):
+    why, all_reason = reached(layout_dir)
+    out = [
+        "// Generated by tools/rgbeffects/gen_rgb_effects.py. Do not edit.",
+        "#pragma once",
+        "",
+    ]
+    if why is None:
+        out.append(f"// Every effect is reachable ({all_reason}); none is excluded.")
+        return "\n".join(out) + "\n"
+    kept = [e for e in EFFECTS if e in why]
+    out.append("// Effects the layout reaches or keeps, besides RGB_MATRIX_SOLID_COLOR:")
+    out += [f"//   {e:<26} {why[e]}" for e in kept] or ["//   none"]
+    out += ["", "// Every other effect is left out of the build."]
+    out += [f"#undef ENABLE_RGB_MATRIX_{e}" for e in EFFECTS if e not in why]
+    return "\n".join(out) + "\n"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("layout_dir")
+    parser.add_argument("--check", action="store_true", help=f"fail if {OUTPUT} is out of date")
+    args = parser.parse_args()
+
+    try:
+        text = generate(args.layout_dir)
+    except (OSError, ValueError) as e:
+        sys.exit(f"gen_rgb_effects: {e}")
+    path = os.path.join(args.layout_dir, OUTPUT)
+    if args.check:
+        try:
+            with open(path) as f:
+                current = f.read()
+        except OSError:
+            current = None
+        if current != text:
+            sys.exit(f"gen_rgb_effects: {path} is out of date, run tools/rgbeffects/gen_rgb_effects.py {args.layout_dir}")
+        return
+    with open(path, "w") as f:
+        f.write(text)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,108 @@
+#pragma once
+
+// Interface between the simulated QMK core (sim_core.c) and the trace
+// replay driver (sim_main.c).
+
+#include QMK_KEYBOARD_H
+
+#define SIM_MAX_REPORTS 65536
+#define SIM_MAX_DECISIONS 16384
+#define SIM_MAX_RAWHID 1024
+
+typedef enum {
+  SIM_REPORT_KEYBOARD,
+  SIM_REPORT_CONSUMER,
+  SIM_REPORT_MOUSE,
+} sim_report_kind_t;
+
+// One HID report as it left the keyboard. `origin` is the matrix time of the
+// key event whose processing produced it; `host_time` is when the host picks
+// it up given USB_POLLING_INTERVAL_MS.
+typedef struct {
+  sim_report_kind_t kind;
+  uint32_t          time;
+  uint32_t          origin;
+  uint32_t          host_time;
+  uint8_t           mods;
+  uint8_t           keys[6];
+  uint16_t          usage;
+  report_mouse_t    mouse;
+} sim_report_t;
+
+// One raw HID packet, padded to RAW_EPSIZE like on the wire.
+typedef struct {
+  uint32_t time;
+  bool     to_host;
+  uint8_t  data[RAW_EPSIZE];
+} sim_rawhid_t;
+
+typedef enum {
+  SIM_DECIDED_BY_RELEASE,
+  SIM_DECIDED_BY_TERM,
+  SIM_DECIDED_BY_OTHER_KEY,
+  SIM_DECIDED_BY_SAME_HAND,
+  SIM_DECIDED_BY_NESTED_TAP,
+} sim_decision_reason_t;
+
+// Outcome of one tap-hold key as resolved by the tapping state machine.
+typedef struct {
+  uint32_t              press_time;
+  uint32_t              decide_time;
+  keypos_t              key;
+  uint16_t              keycode;
+  uint16_t              term;
+  bool                  hold;
+  sim_decision_reason_t reason;
+} sim_decision_t;
+
+// Hooks into layout code whose cost is measured individually.
+typedef enum {
+  SIM_HOOK_PRE_PROCESS_RECORD_USER,
+  SIM_HOOK_PROCESS_RECORD_USER,
+  SIM_HOOK_GET_TAPPING_TERM,
+  SIM_HOOK_GET_HOLD_ON_OTHER_KEY_PRESS,
+  SIM_HOOK_GET_CHORDAL_HOLD,
+  SIM_HOOK_LEADER_END_USER,
+  SIM_HOOK_RGB_MATRIX_INDICATORS_USER,
+  SIM_HOOK_COUNT,
+} sim_hook_t;
+
+typedef struct {
+  uint64_t calls;
+  uint64_t ns_total;
+  uint64_t ns_max;
+  uint64_t instructions_total;
+} sim_hook_stats_t;
+
+typedef struct {
+  uint32_t         now;
+  uint32_t         report_count;
+  sim_report_t     reports[SIM_MAX_REPORTS];
+  uint32_t         decision_count;
+  sim_decision_t   decisions[SIM_MAX_DECISIONS];
+  uint64_t         combo_checks;
+  uint32_t         combo_buffered_ms;
+  uint32_t         combos_fired;
+  uint32_t         rgb_frames;
+  sim_hook_stats_t hooks[SIM_HOOK_COUNT];
+  rgb_t            leds[RGB_MATRIX_LED_COUNT];
+  uint32_t         led_writes;
+  uint64_t         led_hash;
+  uint32_t         rawhid_count;
+  sim_rawhid_t     rawhid[SIM_MAX_RAWHID];
+  uint32_t         eeprom_writes;
+  uint32_t         eeprom_bytes;
+} sim_state_t;
+
+extern sim_state_t sim;
+
+void sim_reset(void);
+void sim_matrix_event(keypos_t key, bool pressed);
+void sim_scan(void);
+void sim_advance_to(uint32_t time);
+void sim_rawhid_log_received(const uint8_t *data, uint8_t length);
+
+const char *sim_hook_name(sim_hook_t hook);
+bool        sim_counter_open(void);
+uint64_t    sim_counter_read(void);
+uint64_t    sim_clock_ns(void);
@@ -0,0 +1,1899 @@
+// Simulated QMK core for replaying key traces through a layout on the host.
+//
+// This models the parts of quantum/ that decide what reaches the host: layer
+// resolution with the source-layer cache, the action_tapping state machine,
+// one-shot layers and mods, combos, key overrides, leader, caps word, repeat
+// key and keyboard report generation. It follows upstream behaviour closely
+// enough that hold/tap decisions and report sequences match the firmware for
+// the features the layouts in this repository use; it is not a general QMK
+// port.
+
+#include "sim.h"
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "sim_introspection.h"
+
+sim_state_t sim;
+
+layer_state_t     layer_state;
+layer_state_t     default_layer_state;
+keyboard_config_t keyboard_config;
+rawhid_state_t    rawhid_state;
+rgb_config_t      rgb_matrix_config;
+
+/* ---------------------------------------------------------------------------
+ * Cost measurement
+ */
+
+static int      counter_fd = -1;
+static uint64_t timing_overhead_ns;
+
+uint64_t sim_clock_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+bool sim_counter_open(void) {
+  if (counter_fd >= 0) {
+    return true;
+  }
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.type           = PERF_TYPE_HARDWARE;
+  attr.size           = sizeof(attr);
+  attr.config         = PERF_COUNT_HW_INSTRUCTIONS;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv     = 1;
+  counter_fd          = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+  if (counter_fd < 0) {
+    return false;
+  }
+  ioctl(counter_fd, PERF_EVENT_IOC_RESET, 0);
+  ioctl(counter_fd, PERF_EVENT_IOC_ENABLE, 0);
+  return true;
+}
+
+uint64_t sim_counter_read(void) {
+  uint64_t value = 0;
+  if (counter_fd < 0 || read(counter_fd, &value, sizeof(value)) != sizeof(value)) {
+    return 0;
+  }
+  return value;
+}
+
+static void hook_account(sim_hook_t hook, uint64_t t0, uint64_t i0) {
+  uint64_t ns    = sim_clock_ns() - t0;
+  uint64_t instr = sim_counter_read() - i0;
+  ns             = ns > timing_overhead_ns ? ns - timing_overhead_ns : 0;
+
+  sim_hook_stats_t *stats = &sim.hooks[hook];
+  stats->calls++;
+  stats->ns_total += ns;
+  stats->instructions_total += instr;
+  if (ns > stats->ns_max) {
+    stats->ns_max = ns;
+  }
+}
+
+#define SIM_TIMED(hook, expr) \
+  do { \
+    uint64_t i0_ = sim_counter_read(); \
+    uint64_t t0_ = sim_clock_ns(); \
+    expr; \
+    hook_account((hook), t0_, i0_); \
+  } while (0)
+
+static void calibrate_timing(void) {
+  uint64_t best = UINT64_MAX;
+  for (int i = 0; i < 1000; i++) {
+    uint64_t t0 = sim_clock_ns();
+    uint64_t t1 = sim_clock_ns();
+    if (t1 - t0 < best) {
+      best = t1 - t0;
+    }
+  }
+  timing_overhead_ns = best;
+}
+
+const char *sim_hook_name(sim_hook_t hook) {
+  switch (hook) {
+    case SIM_HOOK_PRE_PROCESS_RECORD_USER:
+      return "pre_process_record_user";
+    case SIM_HOOK_PROCESS_RECORD_USER:
+      return "process_record_user";
+    case SIM_HOOK_GET_TAPPING_TERM:
+      return "get_tapping_term";
+    case SIM_HOOK_GET_HOLD_ON_OTHER_KEY_PRESS:
+      return "get_hold_on_other_key_press";
+    case SIM_HOOK_GET_CHORDAL_HOLD:
+      return "get_chordal_hold";
+    case SIM_HOOK_LEADER_END_USER:
+      return "leader_end_user";
+    case SIM_HOOK_RGB_MATRIX_INDICATORS_USER:
+      return "rgb_matrix_indicators_user";
+    default:
+      return "?";
+  }
+}
+
+/* ---------------------------------------------------------------------------
+ * Timers
+ */
+
+uint16_t timer_read(void) {
+  return (uint16_t)sim.now;
+}
+
+uint32_t timer_read32(void) {
+  return sim.now;
+}
+
+uint16_t timer_elapsed(uint16_t last) {
+  return TIMER_DIFF_16(timer_read(), last);
+}
+
+uint32_t timer_elapsed32(uint32_t last) {
+  return sim.now - last;
+}
+
+void wait_ms(uint16_t ms) {
+  // Blocking waits stall the scan loop in the firmware; the simulator only
+  // moves the clock so that later reports carry the delay.
+  sim.now += ms;
+}
+
+// Event times are 16-bit like in QMK; widen them against the current clock.
+static uint32_t event_time32(uint16_t time) {
+  return sim.now - (uint16_t)(timer_read() - time);
+}
+
+/* ---------------------------------------------------------------------------
+ * Keyboard report
+ */
+
+static uint8_t  real_mods;
+static uint8_t  weak_mods;
+static uint8_t  oneshot_mods;
+static uint32_t oneshot_mods_time;
+static uint8_t  report_keys[6];
+static uint8_t  sent_mods;
+static uint8_t  sent_keys[6];
+static uint32_t origin_time;
+static uint32_t host_slot[3];
+
+static void emit_report(sim_report_t report) {
+  uint32_t *slot = &host_slot[report.kind];
+  uint32_t  next = (report.time / USB_POLLING_INTERVAL_MS + 1) * USB_POLLING_INTERVAL_MS;
+  if (next <= *slot) {
+    next = *slot + USB_POLLING_INTERVAL_MS;
+  }
+  *slot            = next;
+  report.host_time = next;
+  if (sim.report_count < SIM_MAX_REPORTS) {
+    sim.reports[sim.report_count++] = report;
+  }
+}
+
+static bool has_anykey(void) {
+  for (uint8_t i = 0; i < sizeof(report_keys); i++) {
+    if (report_keys[i]) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Default host driver: hand the report to the simulated USB endpoint.
+static void sim_send_keyboard(report_keyboard_t *report) {
+  sim_report_t r = {
+    .kind   = SIM_REPORT_KEYBOARD,
+    .time   = sim.now,
+    .origin = origin_time,
+    .mods   = report->mods,
+  };
+  memcpy(r.keys, report->keys, sizeof(r.keys));
+  emit_report(r);
+}
+
+static void sim_send_extra(report_extra_t *report) {
+  emit_report((sim_report_t){
+    .kind   = SIM_REPORT_CONSUMER,
+    .time   = sim.now,
+    .origin = origin_time,
+    .usage  = report->usage,
+  });
+}
+
+static void sim_send_mouse(report_mouse_t *report) {
+  emit_report((sim_report_t){
+    .kind   = SIM_REPORT_MOUSE,
+    .time   = sim.now,
+    .origin = origin_time,
+    .mouse  = *report,
+  });
+}
+
+static host_driver_t  sim_driver = {
+  .send_keyboard = sim_send_keyboard,
+  .send_mouse    = sim_send_mouse,
+  .send_extra    = sim_send_extra,
+};
+static host_driver_t *host_driver = &sim_driver;
+
+host_driver_t *host_get_driver(void) {
+  return host_driver;
+}
+
+void host_set_driver(host_driver_t *driver) {
+  host_driver = driver;
+}
+
+void send_keyboard_report(void) {
+  uint8_t mods = real_mods | weak_mods;
+  if (oneshot_mods) {
+    mods |= oneshot_mods;
+    if (has_anykey()) {
+      clear_oneshot_mods();
+    }
+  }
+  if (mods == sent_mods && memcmp(report_keys, sent_keys, sizeof(sent_keys)) == 0) {
+    return;
+  }
+  sent_mods = mods;
+  memcpy(sent_keys, report_keys, sizeof(sent_keys));
+
+  report_keyboard_t report = {.mods = mods};
+  memcpy(report.keys, report_keys, sizeof(report.keys));
+  host_driver->send_keyboard(&report);
+}
+
+void host_mouse_send(report_mouse_t *report) {
+  host_driver->send_mouse(report);
+}
+
+// Mouse buttons are not modelled, so none are ever held.
+report_mouse_t mousekey_get_report(void) {
+  return (report_mouse_t){0};
+}
+
+static void send_consumer(uint16_t usage) {
+  report_extra_t report = {.usage = usage};
+  host_driver->send_extra(&report);
+}
+
+/* ---------------------------------------------------------------------------
+ * Raw HID
+ */
+
+static void record_rawhid(bool to_host, const uint8_t *data, uint8_t length) {
+  if (sim.rawhid_count == SIM_MAX_RAWHID) {
+    return;
+  }
+  sim_rawhid_t *m = &sim.rawhid[sim.rawhid_count++];
+  m->time         = sim.now;
+  m->to_host      = to_host;
+  memset(m->data, 0, sizeof(m->data));
+  memcpy(m->data, data, length < RAW_EPSIZE ? length : RAW_EPSIZE);
+}
+
+void raw_hid_send(uint8_t *data, uint8_t length) {
+  record_rawhid(true, data, length);
+}
+
+void sim_rawhid_log_received(const uint8_t *data, uint8_t length) {
+  record_rawhid(false, data, length);
+}
+
+// Stands in for Oryx's handler, which the simulator does not model. Layouts
+// that wrap raw_hid_receive reach this as __real_raw_hid_receive.
+__attribute__((weak)) void raw_hid_receive(uint8_t *data, uint8_t length) {}
+
+static bool is_key_pressed(uint8_t code) {
+  for (uint8_t i = 0; i < sizeof(report_keys); i++) {
+    if (report_keys[i] == code) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void add_key(uint8_t code) {
+  for (uint8_t i = 0; i < sizeof(report_keys); i++) {
+    if (report_keys[i] == code) {
+      return;
+    }
+  }
+  for (uint8_t i = 0; i < sizeof(report_keys); i++) {
+    if (!report_keys[i]) {
+      report_keys[i] = code;
+      return;
+    }
+  }
+}
+
+void del_key(uint8_t code) {
+  for (uint8_t i = 0; i < sizeof(report_keys); i++) {
+    if (report_keys[i] == code) {
+      report_keys[i] = 0;
+    }
+  }
+}
+
+static uint8_t mod_config(uint8_t mod5) {
+  return (mod5 & 0x10) ? (uint8_t)((mod5 & 0x0F) << 4) : (uint8_t)(mod5 & 0x0F);
+}
+
+uint8_t extract_mod_bits(uint16_t code) {
+  return mod_config(QK_MODS_GET_MODS(code));
+}
+
+uint8_t get_mods(void) {
+  return real_mods;
+}
+
+void add_mods(uint8_t mods) {
+  real_mods |= mods;
+}
+
+void del_mods(uint8_t mods) {
+  real_mods &= (uint8_t)~mods;
+}
+
+void set_mods(uint8_t mods) {
+  real_mods = mods;
+}
+
+void clear_mods(void) {
+  real_mods = 0;
+}
+
+uint8_t get_weak_mods(void) {
+  return weak_mods;
+}
+
+void add_weak_mods(uint8_t mods) {
+  weak_mods |= mods;
+}
+
+void del_weak_mods(uint8_t mods) {
+  weak_mods &= (uint8_t)~mods;
+}
+
+void clear_weak_mods(void) {
+  weak_mods = 0;
+}
+
+uint8_t get_oneshot_mods(void) {
+  return oneshot_mods;
+}
+
+void add_oneshot_mods(uint8_t mods) {
+  oneshot_mods |= mods;
+  oneshot_mods_time = sim.now;
+}
+
+void set_oneshot_mods(uint8_t mods) {
+  oneshot_mods      = mods;
+  oneshot_mods_time = sim.now;
+}
+
+void clear_oneshot_mods(void) {
+  oneshot_mods = 0;
+}
+
+static uint8_t ko_suppressed_mods;
+
+void register_mods(uint8_t mods) {
+  if (mods) {
+    add_mods(mods);
+    send_keyboard_report();
+  }
+}
+
+void unregister_mods(uint8_t mods) {
+  if (mods) {
+    del_mods(mods);
+    ko_suppressed_mods &= (uint8_t)~mods;
+    send_keyboard_report();
+  }
+}
+
+static void register_weak_mods(uint8_t mods) {
+  if (mods) {
+    add_weak_mods(mods);
+    send_keyboard_report();
+  }
+}
+
+static void unregister_weak_mods(uint8_t mods) {
+  if (mods) {
+    del_weak_mods(mods);
+    send_keyboard_report();
+  }
+}
+
+void register_code(uint8_t code) {
+  if (code == KC_NO) {
+    return;
+  }
+  if (IS_MODIFIER_KEYCODE(code)) {
+    add_mods(MOD_BIT(code));
+    send_keyboard_report();
+  } else if (IS_CONSUMER_KEYCODE(code)) {
+    send_consumer(code);
+  } else if (IS_MOUSE_KEYCODE(code)) {
+    // Mouse keys have their own report pipeline that is not modelled.
+  } else {
+    // Force a fresh press if the key is already down, as QMK does.
+    if (is_key_pressed(code)) {
+      del_key(code);
+      send_keyboard_report();
+    }
+    add_key(code);
+    send_keyboard_report();
+  }
+}
+
+void unregister_code(uint8_t code) {
+  if (code == KC_NO) {
+    return;
+  }
+  if (IS_MODIFIER_KEYCODE(code)) {
+    del_mods(MOD_BIT(code));
+    ko_suppressed_mods &= (uint8_t)~MOD_BIT(code);
+    send_keyboard_report();
+  } else if (IS_CONSUMER_KEYCODE(code)) {
+    send_consumer(0);
+  } else if (IS_MOUSE_KEYCODE(code)) {
+  } else {
+    del_key(code);
+    send_keyboard_report();
+  }
+}
+
+void tap_code(uint8_t code) {
+  tap_code16(code);
+}
+
+void register_code16(uint16_t code) {
+  if (IS_MODIFIER_KEYCODE(code) || code == KC_NO) {
+    register_mods(mod_config(QK_MODS_GET_MODS(code)));
+  } else {
+    register_weak_mods(mod_config(QK_MODS_GET_MODS(code)));
+  }
+  register_code(QK_MODS_GET_BASIC_KEYCODE(code));
+}
+
+void unregister_code16(uint16_t code) {
+  unregister_code(QK_MODS_GET_BASIC_KEYCODE(code));
+  if (IS_MODIFIER_KEYCODE(code) || code == KC_NO) {
+    unregister_mods(mod_config(QK_MODS_GET_MODS(code)));
+  } else {
+    unregister_weak_mods(mod_config(QK_MODS_GET_MODS(code)));
+  }
+}
+
+void tap_code16(uint16_t code) {
+  register_code16(code);
+#if defined(TAP_CODE_DELAY) && TAP_CODE_DELAY > 0
+  wait_ms(TAP_CODE_DELAY);
+#endif
+  unregister_code16(code);
+}
+
+void clear_keyboard(void) {
+  clear_mods();
+  clear_weak_mods();
+  clear_oneshot_mods();
+  memset(report_keys, 0, sizeof(report_keys));
+  send_keyboard_report();
+}
+
+/* ---------------------------------------------------------------------------
+ * Layers
+ */
+
+__attribute__((weak)) layer_state_t layer_state_set_user(layer_state_t state) {
+  return state;
+}
+
+__attribute__((weak)) layer_state_t default_layer_state_set_user(layer_state_t state) {
+  return state;
+}
+
+void layer_state_set(layer_state_t state) {
+  layer_state = layer_state_set_user(state);
+}
+
+void layer_clear(void) {
+  layer_state_set(0);
+}
+
+void layer_move(uint8_t layer) {
+  layer_state_set((layer_state_t)1 << layer);
+}
+
+void layer_on(uint8_t layer) {
+  layer_state_set(layer_state | ((layer_state_t)1 << layer));
+}
+
+void layer_off(uint8_t layer) {
+  layer_state_set(layer_state & ~((layer_state_t)1 << layer));
+}
+
+void layer_invert(uint8_t layer) {
+  layer_state_set(layer_state ^ ((layer_state_t)1 << layer));
+}
+
+bool layer_state_cmp(layer_state_t state, uint8_t layer) {
+  if (!state) {
+    return layer == 0;
+  }
+  return (state & ((layer_state_t)1 << layer)) != 0;
+}
+
+bool layer_state_is(uint8_t layer) {
+  return layer_state_cmp(layer_state, layer);
+}
+
+void default_layer_set(layer_state_t state) {
+  default_layer_state = default_layer_state_set_user(state);
+}
+
+uint8_t get_highest_layer(layer_state_t state) {
+  uint8_t layer = 0;
+  for (uint8_t i = 0; i < MAX_LAYER; i++) {
+    if (state & ((layer_state_t)1 << i)) {
+      layer = i;
+    }
+  }
+  return layer;
+}
+
+uint8_t biton16(uint16_t bits) {
+  return get_highest_layer(bits);
+}
+
+uint8_t biton32(uint32_t bits) {
+  uint8_t n = 0;
+  while (bits >>= 1) {
+    n++;
+  }
+  return n;
+}
+
+__attribute__((weak)) uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t key) {
+  if (key.row < MATRIX_ROWS && key.col < MATRIX_COLS) {
+    return keycode_at_keymap_location(layer, key.row, key.col);
+  }
+  return KC_NO;
+}
+
+static uint8_t source_layers[MATRIX_ROWS][MATRIX_COLS];
+
+uint8_t read_source_layers_cache(keypos_t key) {
+  return source_layers[key.row][key.col];
+}
+
+static uint8_t layer_switch_get_layer(keypos_t key) {
+  layer_state_t layers = layer_state | default_layer_state;
+  for (int8_t i = MAX_LAYER - 1; i >= 0; i--) {
+    if (layers & ((layer_state_t)1 << i)) {
+      if (keymap_key_to_keycode((uint8_t)i, key) != KC_TRANSPARENT) {
+        return (uint8_t)i;
+      }
+    }
+  }
+  return 0;
+}
+
+// Mirrors get_record_keycode(): presses resolve against the current layer
+// state, releases reuse the layer the press resolved to.
+static uint16_t record_keycode(const keyrecord_t *record, bool update_layer_cache) {
+  if (record->event.type == COMBO_EVENT) {
+    return record->keycode;
+  }
+  keypos_t key = record->event.key;
+  if (key.row >= MATRIX_ROWS || key.col >= MATRIX_COLS) {
+    return KC_NO;
+  }
+  uint8_t layer;
+  if (record->event.pressed) {
+    layer = layer_switch_get_layer(key);
+    if (update_layer_cache) {
+      source_layers[key.row][key.col] = layer;
+    }
+  } else {
+    layer = source_layers[key.row][key.col];
+  }
+  return keymap_key_to_keycode(layer, key);
+}
+
+/* ---------------------------------------------------------------------------
+ * RGB matrix
+ */
+
+rgb_t hsv_to_rgb(hsv_t hsv) {
+  rgb_t rgb;
+  if (hsv.s == 0) {
+    rgb.r = rgb.g = rgb.b = hsv.v;
+    return rgb;
+  }
+  uint16_t h         = hsv.h;
+  uint16_t s         = hsv.s;
+  uint16_t v         = hsv.v;
+  uint8_t  region    = (uint8_t)(h * 6 / 255);
+  uint8_t  remainder = (uint8_t)((h * 2 - region * 85) * 3);
+  uint8_t  p         = (uint8_t)((v * (255 - s)) >> 8);
+  uint8_t  q         = (uint8_t)((v * (255 - ((s * remainder) >> 8))) >> 8);
+  uint8_t  t         = (uint8_t)((v * (255 - ((s * (255 - remainder)) >> 8))) >> 8);
+  switch (region) {
+    case 6:
+    case 0:
+      rgb = (rgb_t){(uint8_t)v, t, p};
+      break;
+    case 1:
+      rgb = (rgb_t){q, (uint8_t)v, p};
+      break;
+    case 2:
+      rgb = (rgb_t){p, (uint8_t)v, t};
+      break;
+    case 3:
+      rgb = (rgb_t){p, q, (uint8_t)v};
+      break;
+    case 4:
+      rgb = (rgb_t){t, p, (uint8_t)v};
+      break;
+    default:
+      rgb = (rgb_t){(uint8_t)v, p, q};
+      break;
+  }
+  return rgb;
+}
+
+// What the EEPROM holds. The _noeeprom calls change only the live config;
+// every other call writes the whole live config back, as upstream does.
+static rgb_config_t rgb_matrix_saved;
+
+void rgb_matrix_enable_noeeprom(void) {
+  rgb_matrix_config.enable = 1;
+}
+
+void rgb_matrix_enable(void) {
+  rgb_matrix_enable_noeeprom();
+  rgb_matrix_saved = rgb_matrix_config;
+}
+
+void rgb_matrix_disable_noeeprom(void) {
+  rgb_matrix_config.enable = 0;
+}
+
+void rgb_matrix_disable(void) {
+  rgb_matrix_disable_noeeprom();
+  rgb_matrix_saved = rgb_matrix_config;
+}
+
+void rgb_matrix_toggle(void) {
+  rgb_matrix_config.enable ^= 1;
+  rgb_matrix_saved = rgb_matrix_config;
+}
+
+bool rgb_matrix_is_enabled(void) {
+  return rgb_matrix_config.enable;
+}
+
+void rgb_matrix_mode_noeeprom(uint8_t mode) {
+  rgb_matrix_config.mode = mode;
+}
+
+void rgb_matrix_mode(uint8_t mode) {
+  rgb_matrix_mode_noeeprom(mode);
+  rgb_matrix_saved = rgb_matrix_config;
+}
+
+void rgb_matrix_reload_from_eeprom(void) {
+  rgb_matrix_config = rgb_matrix_saved;
+}
+
+void rgb_matrix_sethsv(uint8_t hue, uint8_t sat, uint8_t val) {
+  rgb_matrix_config.hsv = (hsv_t){hue, sat, val};
+  rgb_matrix_saved      = rgb_matrix_config;
+}
+
+uint8_t rgb_matrix_get_val(void) {
+  return rgb_matrix_config.hsv.v;
+}
+
+void rgb_matrix_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
+  if (index >= 0 && index < RGB_MATRIX_LED_COUNT) {
+    sim.leds[index] = (rgb_t){red, green, blue};
+    sim.led_writes++;
+  }
+}
+
+void rgb_matrix_set_color_all(uint8_t red, uint8_t green, uint8_t blue) {
+  for (int i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+    rgb_matrix_set_color(i, red, green, blue);
+  }
+}
+
+led_flags_t rgb_matrix_get_flags(void) {
+  return rgb_matrix_config.flags;
+}
+
+__attribute__((weak)) bool rgb_matrix_indicators_user(void) {
+  return true;
+}
+
+bool rgb_matrix_indicators_kb(void) {
+  bool cont;
+  SIM_TIMED(SIM_HOOK_RGB_MATRIX_INDICATORS_USER, cont = rgb_matrix_indicators_user());
+  return cont;
+}
+
+static uint32_t rgb_frame_time;
+
+static void rgb_matrix_task(void) {
+  if (!rgb_matrix_config.enable || sim.now - rgb_frame_time < RGB_MATRIX_LED_FLUSH_LIMIT) {
+    return;
+  }
+  rgb_frame_time = sim.now;
+  sim.rgb_frames++;
+
+  // Solid colour effect, then indicators on top, like rgb_task_render().
+  rgb_t base = hsv_to_rgb(rgb_matrix_config.hsv);
+  for (int i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+    sim.leds[i] = base;
+  }
+  rgb_matrix_indicators_kb();
+
+  // FNV-1a over every rendered frame, so LED output can be compared across
+  // changes without listing it.
+  for (int i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+    const uint8_t *c = (const uint8_t *)&sim.leds[i];
+    for (size_t b = 0; b < sizeof(sim.leds[i]); b++) {
+      sim.led_hash = (sim.led_hash ^ c[b]) * 0x100000001b3ULL;
+    }
+  }
+}
+
+static void process_rgb(uint16_t keycode) {
+  hsv_t *hsv = &rgb_matrix_config.hsv;
+  switch (keycode) {
+    case RGB_TOG:
+      rgb_matrix_toggle();
+      break;
+    case RGB_MODE_FORWARD:
+      rgb_matrix_config.mode++;
+      break;
+    case RGB_MODE_REVERSE:
+      rgb_matrix_config.mode--;
+      break;
+    case RGB_HUI:
+      hsv->h += RGB_MATRIX_HUE_STEP;
+      break;
+    case RGB_HUD:
+      hsv->h -= RGB_MATRIX_HUE_STEP;
+      break;
+    case RGB_SAI:
+      hsv->s = hsv->s > 255 - RGB_MATRIX_SAT_STEP ? 255 : hsv->s + RGB_MATRIX_SAT_STEP;
+      break;
+    case RGB_SAD:
+      hsv->s = hsv->s < RGB_MATRIX_SAT_STEP ? 0 : hsv->s - RGB_MATRIX_SAT_STEP;
+      break;
+    case RGB_VAI:
+      hsv->v = hsv->v > RGB_MATRIX_MAXIMUM_BRIGHTNESS - RGB_MATRIX_VAL_STEP ? RGB_MATRIX_MAXIMUM_BRIGHTNESS : hsv->v + RGB_MATRIX_VAL_STEP;
+      break;
+    case RGB_VAD:
+      hsv->v = hsv->v < RGB_MATRIX_VAL_STEP ? 0 : hsv->v - RGB_MATRIX_VAL_STEP;
+      break;
+    case RGB_SPI:
+      rgb_matrix_config.speed += RGB_MATRIX_SPD_STEP;
+      break;
+    case RGB_SPD:
+      rgb_matrix_config.speed -= RGB_MATRIX_SPD_STEP;
+      break;
+  }
+  // The keycodes save their result, like the eeprom variants upstream.
+  rgb_matrix_saved = rgb_matrix_config;
+}
+
+/* ---------------------------------------------------------------------------
+ * One-shot layer
+ */
+
+#define ONESHOT_PRESSED 0x01
+#define ONESHOT_OTHER_KEY_PRESSED 0x02
+#define ONESHOT_START (ONESHOT_PRESSED | ONESHOT_OTHER_KEY_PRESSED)
+
+static uint8_t  oneshot_layer;
+static uint8_t  oneshot_layer_state;
+static uint32_t oneshot_layer_time;
+
+static void set_oneshot_layer(uint8_t layer, uint8_t state) {
+  oneshot_layer       = layer;
+  oneshot_layer_state = state;
+  oneshot_layer_time  = sim.now;
+  layer_on(layer);
+}
+
+static void clear_oneshot_layer_state(uint8_t state) {
+  uint8_t start = oneshot_layer_state;
+  oneshot_layer_state &= (uint8_t)~state;
+  if (start && !oneshot_layer_state) {
+    layer_off(oneshot_layer);
+  }
+}
+
+bool is_oneshot_layer_active(void) {
+  return oneshot_layer_state != 0;
+}
+
+static bool is_oneshot_keycode(uint16_t keycode) {
+  return IS_QK_ONE_SHOT_LAYER(keycode) || IS_QK_ONE_SHOT_MOD(keycode);
+}
+
+/* ---------------------------------------------------------------------------
+ * Caps word
+ */
+
+#if defined(CAPS_WORD_ENABLE)
+static bool     caps_word_active;
+static uint32_t caps_word_time;
+
+bool is_caps_word_on(void) {
+  return caps_word_active;
+}
+
+void caps_word_on(void) {
+  caps_word_active = true;
+  caps_word_time   = sim.now;
+  clear_weak_mods();
+}
+
+void caps_word_off(void) {
+  caps_word_active = false;
+  clear_weak_mods();
+  send_keyboard_report();
+}
+
+__attribute__((weak)) bool caps_word_press_user(uint16_t keycode) {
+  switch (keycode) {
+    case KC_A ... KC_Z:
+    case KC_MINS:
+      add_weak_mods(MOD_BIT(KC_LSFT));
+      return true;
+    case KC_1 ... KC_0:
+    case KC_BSPC:
+    case KC_DEL:
+    case S(KC_MINS):
+      return true;
+    default:
+      return false;
+  }
+}
+
+static bool process_caps_word(uint16_t keycode, keyrecord_t *record) {
+  if (keycode == CW_TOGG) {
+    if (record->event.pressed) {
+      if (caps_word_active) {
+        caps_word_off();
+      } else {
+        caps_word_on();
+      }
+    }
+    return false;
+  }
+  if (!caps_word_active || !record->event.pressed) {
+    return true;
+  }
+  caps_word_time = sim.now;
+
+  if (IS_QK_MOD_TAP(keycode) || IS_QK_LAYER_TAP(keycode)) {
+    if (record->tap.count == 0) {
+      return true;
+    }
+    keycode &= 0xFF;
+  }
+  if (IS_MODIFIER_KEYCODE(keycode) || is_oneshot_keycode(keycode) || IS_QK_MOMENTARY(keycode)) {
+    return true;
+  }
+  clear_weak_mods();
+  if (!caps_word_press_user(keycode)) {
+    caps_word_off();
+  }
+  return true;
+}
+#endif
+
+/* ---------------------------------------------------------------------------
+ * Leader
+ */
+
+#if defined(LEADER_ENABLE)
+static bool     leading;
+static uint16_t leader_sequence[5];
+static uint8_t  leader_sequence_size;
+static uint32_t leader_time;
+
+__attribute__((weak)) void leader_start_user(void) {}
+__attribute__((weak)) void leader_end_user(void) {}
+__attribute__((weak)) bool leader_add_user(uint16_t keycode) {
+  return false;
+}
+
+bool leader_sequence_active(void) {
+  return leading;
+}
+
+static bool leader_sequence_is(uint16_t kc1, uint16_t kc2, uint16_t kc3, uint16_t kc4, uint16_t kc5) {
+  return leader_sequence[0] == kc1 && leader_sequence[1] == kc2 && leader_sequence[2] == kc3 && leader_sequence[3] == kc4 && leader_sequence[4] == kc5;
+}
+
+bool leader_sequence_one_key(uint16_t kc) {
+  return leader_sequence_is(kc, 0, 0, 0, 0);
+}
+
+bool leader_sequence_two_keys(uint16_t kc1, uint16_t kc2) {
+  return leader_sequence_is(kc1, kc2, 0, 0, 0);
+}
+
+bool leader_sequence_three_keys(uint16_t kc1, uint16_t kc2, uint16_t kc3) {
+  return leader_sequence_is(kc1, kc2, kc3, 0, 0);
+}
+
+static void leader_start(void) {
+  leading              = true;
+  leader_time          = sim.now;
+  leader_sequence_size = 0;
+  memset(leader_sequence, 0, sizeof(leader_sequence));
+  leader_start_user();
+}
+
+static void leader_end(void) {
+  leading = false;
+  SIM_TIMED(SIM_HOOK_LEADER_END_USER, leader_end_user());
+}
+
+static void leader_task(void) {
+  if (!leading) {
+    return;
+  }
+#    if defined(LEADER_NO_TIMEOUT)
+  if (leader_sequence_size == 0) {
+    return;
+  }
+#    endif
+  if (sim.now - leader_time >= LEADER_TIMEOUT) {
+    leader_end();
+  }
+}
+
+static bool process_leader(uint16_t keycode, keyrecord_t *record) {
+  if (!leading || !record->event.pressed) {
+    return true;
+  }
+  if (IS_QK_MOD_TAP(keycode) || IS_QK_LAYER_TAP(keycode)) {
+    if (record->tap.count == 0) {
+      return true;
+    }
+    keycode &= 0xFF;
+  }
+  leader_sequence[leader_sequence_size++] = keycode;
+#    if defined(LEADER_PER_KEY_TIMING)
+  leader_time = sim.now;
+#    endif
+  // leader_add_user may end the sequence early, as with leader_add_kb upstream.
+  if (leader_add_user(keycode) || leader_sequence_size == ARRAY_SIZE(leader_sequence)) {
+    leader_end();
+  }
+  return false;
+}
+#endif
+
+/* ---------------------------------------------------------------------------
+ * Key overrides
+ */
+
+#if defined(KEY_OVERRIDE_ENABLE)
+static const key_override_t *active_override;
+
+// Left and right variants of a modifier satisfy the same trigger.
+static uint8_t mod_kinds(uint8_t mods) {
+  return (uint8_t)((mods | (mods >> 4)) & 0x0F);
+}
+
+static void deactivate_override(void) {
+  unregister_code16(active_override->replacement);
+  if (ko_suppressed_mods) {
+    add_mods(ko_suppressed_mods);
+    ko_suppressed_mods = 0;
+    send_keyboard_report();
+  }
+  active_override = NULL;
+}
+
+static bool process_key_override(uint16_t keycode, keyrecord_t *record) {
+  if (!record->event.pressed) {
+    if (active_override && active_override->trigger == keycode) {
+      deactivate_override();
+      return false;
+    }
+    return true;
+  }
+  if (active_override) {
+    deactivate_override();
+  }
+
+  uint8_t mods = get_mods() | get_oneshot_mods();
+  for (uint16_t i = 0; i < key_override_count(); i++) {
+    const key_override_t *ko = key_override_get(i);
+    if (ko == NULL) {
+      break;
+    }
+    if (ko->trigger != keycode || (ko->enabled && !*ko->enabled)) {
+      continue;
+    }
+    if (!(ko->layers & ((layer_state_t)1 << get_highest_layer(layer_state | default_layer_state)))) {
+      continue;
+    }
+    if ((mod_kinds(mods) & mod_kinds(ko->trigger_mods)) != mod_kinds(ko->trigger_mods) || (mods & ko->negative_mod_mask)) {
+      continue;
+    }
+    ko_suppressed_mods = get_mods() & ko->suppressed_mods;
+    del_mods(ko_suppressed_mods);
+    del_weak_mods(ko->suppressed_mods);
+    oneshot_mods &= (uint8_t)~ko->suppressed_mods;
+    active_override = ko;
+    register_code16(ko->replacement);
+    return false;
+  }
+  return true;
+}
+#endif
+
+/* ---------------------------------------------------------------------------
+ * Repeat key
+ */
+
+#if defined(REPEAT_KEY_ENABLE)
+static uint16_t last_keycode;
+static uint8_t  last_mods;
+static uint16_t repeating_keycode;
+static bool     repeating;
+
+uint16_t get_last_keycode(void) {
+  return last_keycode;
+}
+
+uint8_t get_last_mods(void) {
+  return last_mods;
+}
+
+void set_last_keycode(uint16_t keycode) {
+  last_keycode = keycode;
+}
+
+void set_last_mods(uint8_t mods) {
+  last_mods = mods;
+}
+
+static void remember_last_key(uint16_t keycode, keyrecord_t *record) {
+  if (repeating || !record->event.pressed || keycode == QK_REPEAT_KEY || IS_MODIFIER_KEYCODE(keycode)) {
+    return;
+  }
+  if (IS_QK_MOD_TAP(keycode) || IS_QK_LAYER_TAP(keycode)) {
+    if (record->tap.count == 0) {
+      return;
+    }
+    keycode &= 0xFF;
+  }
+  if (is_oneshot_keycode(keycode) || IS_QK_TO(keycode) || IS_QK_MOMENTARY(keycode)) {
+    return;
+  }
+  last_keycode = keycode;
+  last_mods    = get_mods() | get_oneshot_mods();
+}
+#endif
+
+/* ---------------------------------------------------------------------------
+ * Record processing
+ */
+
+__attribute__((weak)) bool process_record_user(uint16_t keycode, keyrecord_t *record) {
+  return true;
+}
+
+__attribute__((weak)) void post_process_record_user(uint16_t keycode, keyrecord_t *record) {}
+
+__attribute__((weak)) bool pre_process_record_user(uint16_t keycode, keyrecord_t *record) {
+  return true;
+}
+
+bool pre_process_record_kb(uint16_t keycode, keyrecord_t *record) {
+  bool cont;
+  SIM_TIMED(SIM_HOOK_PRE_PROCESS_RECORD_USER, cont = pre_process_record_user(keycode, record));
+  return cont;
+}
+
+bool process_record_kb(uint16_t keycode, keyrecord_t *record) {
+  bool cont;
+  SIM_TIMED(SIM_HOOK_PROCESS_RECORD_USER, cont = process_record_user(keycode, record));
+  if (!cont) {
+    return false;
+  }
+  switch (keycode) {
+    case TOGGLE_LAYER_COLOR:
+      if (record->event.pressed) {
+        keyboard_config.disable_layer_led ^= 1;
+      }
+      return false;
+    case LED_LEVEL:
+      if (record->event.pressed) {
+        keyboard_config.led_level ^= 1;
+      }
+      return false;
+  }
+  return true;
+}
+
+static void process_action(uint16_t keycode, keyrecord_t *record) {
+  bool    pressed = record->event.pressed;
+  uint8_t tap     = record->tap.count;
+
+  if (IS_QK_BASIC(keycode)) {
+    if (keycode == KC_NO || keycode == KC_TRANSPARENT) {
+      return;
+    }
+    if (pressed) {
+      register_code((uint8_t)keycode);
+    } else {
+      unregister_code((uint8_t)keycode);
+    }
+  } else if (IS_QK_MODS(keycode)) {
+    if (pressed) {
+      register_code16(keycode);
+    } else {
+      unregister_code16(keycode);
+    }
+  } else if (IS_QK_MOD_TAP(keycode)) {
+    uint8_t mods = mod_config(QK_MOD_TAP_GET_MODS(keycode));
+    uint8_t code = QK_MOD_TAP_GET_TAP_KEYCODE(keycode);
+    if (tap > 0) {
+      if (pressed) {
+        register_code(code);
+      } else {
+        unregister_code(code);
+      }
+    } else if (pressed) {
+      register_mods(mods);
+    } else {
+      unregister_mods(mods);
+    }
+  } else if (IS_QK_LAYER_TAP(keycode)) {
+    uint8_t code = QK_LAYER_TAP_GET_TAP_KEYCODE(keycode);
+    if (tap > 0) {
+      if (pressed) {
+        register_code(code);
+      } else {
+        unregister_code(code);
+      }
+    } else if (pressed) {
+      layer_on(QK_LAYER_TAP_GET_LAYER(keycode));
+    } else {
+      layer_off(QK_LAYER_TAP_GET_LAYER(keycode));
+    }
+  } else if (IS_QK_TO(keycode)) {
+    if (pressed) {
+      layer_move(QK_TO_GET_LAYER(keycode));
+    }
+  } else if (IS_QK_MOMENTARY(keycode)) {
+    if (pressed) {
+      layer_on(QK_MOMENTARY_GET_LAYER(keycode));
+    } else {
+      layer_off(QK_MOMENTARY_GET_LAYER(keycode));
+    }
+  } else if (IS_QK_DEF_LAYER(keycode)) {
+    if (pressed) {
+      default_layer_set((layer_state_t)1 << QK_DEF_LAYER_GET_LAYER(keycode));
+    }
+  } else if (IS_QK_TOGGLE_LAYER(keycode)) {
+    if (pressed) {
+      layer_invert(QK_TOGGLE_LAYER_GET_LAYER(keycode));
+    }
+  } else if (IS_QK_ONE_SHOT_LAYER(keycode)) {
+    if (pressed) {
+      set_oneshot_layer(QK_ONE_SHOT_LAYER_GET_LAYER(keycode), ONESHOT_START);
+    } else {
+      clear_oneshot_layer_state(ONESHOT_PRESSED);
+      if (tap > 1) {
+        clear_oneshot_layer_state(ONESHOT_OTHER_KEY_PRESSED);
+      }
+    }
+  } else if (IS_QK_ONE_SHOT_MOD(keycode)) {
+    uint8_t mods = mod_config(QK_ONE_SHOT_MOD_GET_MODS(keycode));
+    if (pressed) {
+      if (tap == 0) {
+        register_mods(mods | get_oneshot_mods());
+      } else {
+        add_oneshot_mods(mods);
+      }
+    } else if (tap == 0) {
+      clear_oneshot_mods();
+      unregister_mods(mods);
+    }
+  } else if (IS_QK_LIGHTING(keycode)) {
+    if (pressed) {
+      process_rgb(keycode);
+    }
+  } else if (keycode == QK_LEADER) {
+#if defined(LEADER_ENABLE)
+    if (pressed) {
+      leader_start();
+    }
+#endif
+  }
+}
+
+static void process_record_quantum(uint16_t keycode, keyrecord_t *record) {
+  if (!(
+#if defined(CAPS_WORD_ENABLE)
+          process_caps_word(keycode, record) &&
+#endif
+#if defined(LEADER_ENABLE)
+          process_leader(keycode, record) &&
+#endif
+#if defined(KEY_OVERRIDE_ENABLE)
+          process_key_override(keycode, record) &&
+#endif
+          true)) {
+    return;
+  }
+#if defined(REPEAT_KEY_ENABLE)
+  remember_last_key(keycode, record);
+#endif
+  if (!process_record_kb(keycode, record)) {
+    return;
+  }
+#if defined(REPEAT_KEY_ENABLE)
+  if (keycode == QK_REPEAT_KEY) {
+    if (record->event.pressed) {
+      repeating_keycode = last_keycode;
+    }
+    if (repeating_keycode) {
+      keyrecord_t repeat = *record;
+      repeat.tap         = (tap_t){0};
+      repeating          = true;
+      process_record_quantum(repeating_keycode, &repeat);
+      repeating = false;
+    }
+    return;
+  }
+#endif
+  process_action(keycode, record);
+  post_process_record_user(keycode, record);
+}
+
+// Positions whose tap-hold key was pressed as a tap. A key settled as tapped
+// can be released after another tap-hold key has taken over the tapping slot;
+// its release must still undo the tap, not the hold.
+static bool tapped_down[MATRIX_ROWS][MATRIX_COLS];
+
+static void process_record(keyrecord_t *record) {
+  if (record->event.type == TICK_EVENT) {
+    return;
+  }
+  uint16_t keycode = record_keycode(record, true);
+  origin_time      = event_time32(record->event.time);
+
+  keypos_t key = record->event.key;
+  if (record->event.type == KEY_EVENT && key.row < MATRIX_ROWS && key.col < MATRIX_COLS) {
+    if (record->event.pressed) {
+      tapped_down[key.row][key.col] = record->tap.count > 0;
+    } else if (tapped_down[key.row][key.col]) {
+      tapped_down[key.row][key.col] = false;
+      if (!record->tap.count) {
+        record->tap.count = 1;
+      }
+    }
+  }
+
+  bool release_oneshot = oneshot_layer_state && record->event.pressed && !is_oneshot_keycode(keycode);
+  process_record_quantum(keycode, record);
+  if (release_oneshot) {
+    clear_oneshot_layer_state(ONESHOT_OTHER_KEY_PRESSED);
+  }
+}
+
+/* ---------------------------------------------------------------------------
+ * Tapping state machine (quantum/action_tapping.c)
+ */
+
+#define WAITING_BUFFER_SIZE 8
+
+typedef enum {
+  TAPPING_IDLE,
+  TAPPING_UNDECIDED,
+  TAPPING_TAPPED_PRESSED,
+  TAPPING_TAPPED_RELEASED,
+} tapping_phase_t;
+
+static tapping_phase_t tapping_phase;
+static keyrecord_t     tapping_key;
+static keyrecord_t     waiting_buffer[WAITING_BUFFER_SIZE];
+static uint8_t         waiting_buffer_head;
+static uint8_t         waiting_buffer_tail;
+
+__attribute__((weak)) uint16_t get_tapping_term(uint16_t keycode, keyrecord_t *record) {
+  return TAPPING_TERM;
+}
+
+__attribute__((weak)) uint16_t get_quick_tap_term(uint16_t keycode, keyrecord_t *record) {
+  return QUICK_TAP_TERM;
+}
+
+__attribute__((weak)) bool get_hold_on_other_key_press(uint16_t keycode, keyrecord_t *record) {
+  return false;
+}
+
+__attribute__((weak)) bool get_permissive_hold(uint16_t keycode, keyrecord_t *record) {
+#if defined(PERMISSIVE_HOLD_PER_KEY)
+  return false;
+#elif defined(PERMISSIVE_HOLD)
+  return true;
+#else
+  return false;
+#endif
+}
+
+#if defined(CHORDAL_HOLD)
+// Layouts normally provide this; fall back to splitting the matrix in half.
+__attribute__((weak)) extern const char chordal_hold_layout[MATRIX_ROWS][MATRIX_COLS];
+
+__attribute__((weak)) char chordal_hold_handedness(keypos_t key) {
+  if (chordal_hold_layout) {
+    return (char)pgm_read_byte(&chordal_hold_layout[key.row][key.col]);
+  }
+  return key.row < MATRIX_ROWS / 2 ? 'L' : 'R';
+}
+
+bool get_chordal_hold_default(keyrecord_t *tap_hold_record, keyrecord_t *other_record) {
+  if (tap_hold_record->event.type != KEY_EVENT || other_record->event.type != KEY_EVENT) {
+    return true;
+  }
+  char tap_hold_hand = chordal_hold_handedness(tap_hold_record->event.key);
+  if (tap_hold_hand == '*') {
+    return true;
+  }
+  char other_hand = chordal_hold_handedness(other_record->event.key);
+  return other_hand == '*' || tap_hold_hand != other_hand;
+}
+
+__attribute__((weak)) bool get_chordal_hold(uint16_t tap_hold_keycode, keyrecord_t *tap_hold_record, uint16_t other_keycode, keyrecord_t *other_record) {
+  return get_chordal_hold_default(tap_hold_record, other_record);
+}
+#endif
+
+static bool same_key(keyevent_t a, keyevent_t b) {
+  return a.type == b.type && a.key.row == b.key.row && a.key.col == b.key.col;
+}
+
+static bool is_tap_keycode(uint16_t keycode) {
+  return IS_QK_MOD_TAP(keycode) || IS_QK_LAYER_TAP(keycode) || is_oneshot_keycode(keycode);
+}
+
+static uint16_t tapping_keycode(void) {
+  return record_keycode(&tapping_key, false);
+}
+
+static uint16_t tapping_term(void) {
+  uint16_t term;
+  SIM_TIMED(SIM_HOOK_GET_TAPPING_TERM, term = get_tapping_term(tapping_keycode(), &tapping_key));
+  return term;
+}
+
+static bool within_tapping_term(uint16_t time) {
+  return TIMER_DIFF_16(time, tapping_key.event.time) < tapping_term();
+}
+
+static void log_decision(bool hold, sim_decision_reason_t reason) {
+  if (sim.decision_count >= SIM_MAX_DECISIONS) {
+    return;
+  }
+  sim.decisions[sim.decision_count++] = (sim_decision_t){
+    .press_time  = event_time32(tapping_key.event.time),
+    .decide_time = sim.now,
+    .key         = tapping_key.event.key,
+    .keycode     = tapping_keycode(),
+    .term        = tapping_term(),
+    .hold        = hold,
+    .reason      = reason,
+  };
+}
+
+static void tapping_resolve_hold(sim_decision_reason_t reason) {
+  log_decision(true, reason);
+  tapping_phase = TAPPING_IDLE;
+  process_record(&tapping_key);
+}
+
+static bool waiting_buffer_has_press(keyevent_t event) {
+  for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
+    if (same_key(waiting_buffer[i].event, event) && waiting_buffer[i].event.pressed) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Returns false when the event must wait in the buffer until the tapping key
+// is resolved.
+static bool process_tapping(keyrecord_t *keyp) {
+  keyevent_t event = keyp->event;
+  bool       tick  = event.type == TICK_EVENT;
+
+  switch (tapping_phase) {
+    case TAPPING_UNDECIDED:
+      if (!within_tapping_term(tick ? timer_read() : event.time)) {
+        tapping_resolve_hold(SIM_DECIDED_BY_TERM);
+        return process_tapping(keyp);
+      }
+      if (tick) {
+        return true;
+      }
+      if (same_key(event, tapping_key.event) && !event.pressed) {
+        log_decision(false, SIM_DECIDED_BY_RELEASE);
+        tapping_key.tap.count = 1;
+        process_record(&tapping_key);
+        keyp->tap     = tapping_key.tap;
+        tapping_phase = TAPPING_TAPPED_PRESSED;
+        return false;
+      }
+      if (event.pressed) {
+#if defined(CHORDAL_HOLD)
+        // The first key pressed during the tapping term decides the chord:
+        // a tap-hold key rolled into from the same hand is settled as tapped.
+        uint16_t tap_hold_keycode = tapping_keycode();
+        if ((IS_QK_MOD_TAP(tap_hold_keycode) || IS_QK_LAYER_TAP(tap_hold_keycode)) && waiting_buffer_tail == waiting_buffer_head) {
+          bool chord;
+          SIM_TIMED(SIM_HOOK_GET_CHORDAL_HOLD, chord = get_chordal_hold(tap_hold_keycode, &tapping_key, record_keycode(keyp, false), keyp));
+          if (!chord) {
+            log_decision(false, SIM_DECIDED_BY_SAME_HAND);
+            tapping_key.tap.count = 1;
+            process_record(&tapping_key);
+            tapping_phase = TAPPING_TAPPED_PRESSED;
+            return process_tapping(keyp);
+          }
+        }
+#endif
+        bool hold;
+        SIM_TIMED(SIM_HOOK_GET_HOLD_ON_OTHER_KEY_PRESS, hold = get_hold_on_other_key_press(tapping_keycode(), &tapping_key));
+        if (hold) {
+          tapping_resolve_hold(SIM_DECIDED_BY_OTHER_KEY);
+          return process_tapping(keyp);
+        }
+        return false;
+      }
+      if (waiting_buffer_has_press(event)) {
+        // A key pressed and released inside the tapping term. With permissive
+        // hold that settles the tapping key as held; the release then waits
+        // behind its press in the buffer.
+        if (get_permissive_hold(tapping_keycode(), &tapping_key)) {
+          tapping_resolve_hold(SIM_DECIDED_BY_NESTED_TAP);
+        }
+        return false;
+      }
+      process_record(keyp);
+      return true;
+
+    case TAPPING_TAPPED_PRESSED:
+      if (tick) {
+        return true;
+      }
+      if (same_key(event, tapping_key.event) && !event.pressed) {
+        keyp->tap = tapping_key.tap;
+        process_record(keyp);
+        tapping_key   = *keyp;
+        tapping_phase = TAPPING_TAPPED_RELEASED;
+        return true;
+      }
+      if (event.pressed && is_tap_keycode(record_keycode(keyp, false))) {
+        tapping_key   = *keyp;
+        tapping_phase = TAPPING_UNDECIDED;
+        return true;
+      }
+      if (event.pressed) {
+        tapping_key.tap.interrupted = true;
+      }
+      process_record(keyp);
+      return true;
+
+    case TAPPING_TAPPED_RELEASED:
+      if (tick) {
+        if (TIMER_DIFF_16(timer_read(), tapping_key.event.time) >= get_quick_tap_term(tapping_keycode(), &tapping_key)) {
+          tapping_phase = TAPPING_IDLE;
+        }
+        return true;
+      }
+      if (same_key(event, tapping_key.event) && event.pressed && TIMER_DIFF_16(event.time, tapping_key.event.time) < get_quick_tap_term(tapping_keycode(), &tapping_key)) {
+        keyp->tap.count = tapping_key.tap.count < 15 ? tapping_key.tap.count + 1 : 15;
+        tapping_key     = *keyp;
+        tapping_phase   = TAPPING_TAPPED_PRESSED;
+        process_record(keyp);
+        return true;
+      }
+      tapping_phase = TAPPING_IDLE;
+      return process_tapping(keyp);
+
+    case TAPPING_IDLE:
+    default:
+      if (tick) {
+        return true;
+      }
+      if (event.pressed && is_tap_keycode(record_keycode(keyp, false))) {
+        tapping_key     = *keyp;
+        tapping_key.tap = (tap_t){0};
+        tapping_phase   = TAPPING_UNDECIDED;
+        return true;
+      }
+      process_record(keyp);
+      return true;
+  }
+}
+
+static void action_tapping_process(keyrecord_t record) {
+  tapping_phase_t phase = tapping_phase;
+  if (!process_tapping(&record)) {
+    uint8_t next = (waiting_buffer_head + 1) % WAITING_BUFFER_SIZE;
+    if (next == waiting_buffer_tail) {
+      // Buffer overflow: QMK clears the keyboard and drops the event.
+      clear_keyboard();
+      waiting_buffer_head = waiting_buffer_tail = 0;
+      tapping_phase                             = TAPPING_IDLE;
+      return;
+    }
+    waiting_buffer[waiting_buffer_head] = record;
+    waiting_buffer_head                 = next;
+    if (tapping_phase == phase) {
+      return;
+    }
+  }
+  while (waiting_buffer_tail != waiting_buffer_head && process_tapping(&waiting_buffer[waiting_buffer_tail])) {
+    waiting_buffer_tail = (waiting_buffer_tail + 1) % WAITING_BUFFER_SIZE;
+  }
+}
+
+/* ---------------------------------------------------------------------------
+ * Combos (pre-processing, ahead of the tapping state machine)
+ */
+
+#if defined(COMBO_ENABLE)
+#    define COMBO_BUFFER_LENGTH 8
+
+static keyrecord_t combo_buffer[COMBO_BUFFER_LENGTH];
+static uint16_t    combo_buffer_combos[COMBO_BUFFER_LENGTH]; // combos each buffered key counts for
+static uint8_t     combo_buffer_size;
+static uint32_t    combo_timer;
+static uint16_t    combo_term;
+static combo_t    *active_combo;
+static keyrecord_t active_combo_record;
+
+#    if defined(COMBO_TERM_PER_COMBO)
+__attribute__((weak)) uint16_t get_combo_term(uint16_t combo_index, combo_t *combo) {
+  return COMBO_TERM;
+}
+#    endif
+
+#    if defined(COMBO_SHOULD_TRIGGER)
+__attribute__((weak)) bool combo_should_trigger(uint16_t combo_index, combo_t *combo, uint16_t keycode, keyrecord_t *record) {
+  return true;
+}
+#    endif
+
+static bool combo_has_key(const combo_t *combo, uint16_t keycode) {
+  sim.combo_checks++;
+  for (const uint16_t *keys = combo->keys; pgm_read_word(keys) != COMBO_END; keys++) {
+    if (pgm_read_word(keys) == keycode) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Combos the pressed key counts for, as a bitmask. Raises combo_term to the
+// longest term among them, as upstream does for the key buffer.
+static uint16_t combo_candidates(uint16_t keycode, keyrecord_t *record) {
+  uint16_t mask = 0;
+  for (uint16_t i = 0; i < combo_count() && i < 16; i++) {
+    combo_t *combo = combo_get(i);
+    if (combo->disabled || !combo_has_key(combo, keycode)) {
+      continue;
+    }
+#    if defined(COMBO_SHOULD_TRIGGER)
+    if (!combo_should_trigger(i, combo, keycode, record)) {
+      continue;
+    }
+#    endif
+    mask |= 1u << i;
+#    if defined(COMBO_TERM_PER_COMBO)
+    uint16_t term = get_combo_term(i, combo);
+#    else
+    uint16_t term = COMBO_TERM;
+#    endif
+    if (term > combo_term) {
+      combo_term = term;
+    }
+  }
+  return mask;
+}
+
+static void combo_dump_buffer(void) {
+  uint8_t size = combo_buffer_size;
+  if (size) {
+    sim.combo_buffered_ms += sim.now - combo_timer;
+  }
+  combo_buffer_size = 0;
+  combo_term        = 0;
+  for (uint8_t i = 0; i < size; i++) {
+    action_tapping_process(combo_buffer[i]);
+  }
+}
+
+static combo_t *combo_completed(void) {
+  for (uint16_t i = 0; i < combo_count() && i < 16; i++) {
+    combo_t *combo = combo_get(i);
+    if (combo->disabled) {
+      continue;
+    }
+    uint8_t matched = 0, length = 0;
+    for (const uint16_t *keys = combo->keys; pgm_read_word(keys) != COMBO_END; keys++) {
+      length++;
+      for (uint8_t b = 0; b < combo_buffer_size; b++) {
+        sim.combo_checks++;
+        if ((combo_buffer_combos[b] & (1u << i)) && combo_buffer[b].keycode == pgm_read_word(keys)) {
+          matched++;
+          break;
+        }
+      }
+    }
+    if (length && matched == length) {
+      return combo;
+    }
+  }
+  return NULL;
+}
+
+// Returns false when the event was consumed by the combo engine.
+static bool process_combo_event(keyrecord_t *record) {
+  uint16_t keycode = record_keycode(record, false);
+
+  if (record->event.pressed) {
+    if (combo_buffer_size == COMBO_BUFFER_LENGTH) {
+      combo_dump_buffer();
+    }
+    uint16_t combos = combo_candidates(keycode, record);
+    if (!combos) {
+      combo_dump_buffer();
+      return true;
+    }
+    if (!combo_buffer_size) {
+      combo_timer = sim.now;
+    }
+    record->keycode                       = keycode;
+    combo_buffer_combos[combo_buffer_size] = combos;
+    combo_buffer[combo_buffer_size++]     = *record;
+
+    combo_t *combo = combo_completed();
+    if (combo) {
+      sim.combo_buffered_ms += sim.now - combo_timer;
+      sim.combos_fired++;
+      active_combo        = combo;
+      combo_buffer_size   = 0;
+      combo_term          = 0;
+      active_combo_record = (keyrecord_t){
+        .event   = {.key = {.row = KEYLOC_COMBO, .col = KEYLOC_COMBO}, .time = record->event.time, .type = COMBO_EVENT, .pressed = true},
+        .keycode = combo->keycode,
+      };
+      action_tapping_process(active_combo_record);
+    }
+    return false;
+  }
+
+  if (active_combo && combo_has_key(active_combo, keycode)) {
+    active_combo_record.event.pressed = false;
+    active_combo_record.event.time    = record->event.time;
+    active_combo                      = NULL;
+    action_tapping_process(active_combo_record);
+    return false;
+  }
+  for (uint8_t b = 0; b < combo_buffer_size; b++) {
+    if (same_key(combo_buffer[b].event, record->event)) {
+      combo_dump_buffer();
+      break;
+    }
+  }
+  return true;
+}
+
+static void combo_task(void) {
+  if (combo_buffer_size && sim.now - combo_timer >= combo_term) {
+    combo_dump_buffer();
+  }
+}
+#endif
+
+/* ---------------------------------------------------------------------------
+ * Scan loop
+ */
+
+static uint32_t eeconfig_user;
+
+uint32_t eeconfig_read_user(void) {
+  return eeconfig_user;
+}
+
+void eeconfig_update_user(uint32_t val) {
+  eeconfig_user = val;
+}
+
+__attribute__((weak)) void eeconfig_init_user(void) {
+  eeconfig_update_user(0);
+}
+
+#if defined(EECONFIG_USER_DATA_SIZE) && EECONFIG_USER_DATA_SIZE > 0
+static uint8_t eeconfig_user_data[EECONFIG_USER_DATA_SIZE];
+
+void eeconfig_read_user_datablock(void *data, uint32_t offset, uint32_t length) {
+  if (offset + length <= sizeof(eeconfig_user_data)) {
+    memcpy(data, eeconfig_user_data + offset, length);
+  }
+}
+
+// Counts calls and the bytes that actually changed, like eeprom_update_block.
+void eeconfig_update_user_datablock(const void *data, uint32_t offset, uint32_t length) {
+  if (offset + length > sizeof(eeconfig_user_data)) {
+    return;
+  }
+  const uint8_t *src = data;
+  sim.eeprom_writes++;
+  for (uint32_t i = 0; i < length; i++) {
+    sim.eeprom_bytes += eeconfig_user_data[offset + i] != src[i];
+  }
+  memcpy(eeconfig_user_data + offset, data, length);
+}
+#endif
+
+__attribute__((weak)) void keyboard_post_init_user(void) {}
+__attribute__((weak)) void matrix_scan_user(void) {}
+__attribute__((weak)) void housekeeping_task_user(void) {}
+
+void sim_matrix_event(keypos_t key, bool pressed) {
+  keyrecord_t record = {
+    .event = {.key = key, .time = timer_read(), .type = KEY_EVENT, .pressed = pressed},
+  };
+  // pre_process_record_quantum(): sees every matrix event before combos and
+  // the tapping state machine. Reports sent from there belong to this event.
+  uint32_t origin = origin_time;
+  origin_time     = event_time32(record.event.time);
+  if (!pre_process_record_kb(record_keycode(&record, false), &record)) {
+    return;
+  }
+  origin_time = origin;
+#if defined(COMBO_ENABLE)
+  if (!process_combo_event(&record)) {
+    return;
+  }
+#endif
+  action_tapping_process(record);
+}
+
+void sim_scan(void) {
+#if defined(COMBO_ENABLE)
+  combo_task();
+#endif
+  action_tapping_process((keyrecord_t){.event = {.time = timer_read(), .type = TICK_EVENT}});
+
+#if ONESHOT_TIMEOUT > 0
+  if (oneshot_layer_state && !(oneshot_layer_state & ONESHOT_PRESSED) && sim.now - oneshot_layer_time >= ONESHOT_TIMEOUT) {
+    clear_oneshot_layer_state(ONESHOT_START);
+  }
+  if (oneshot_mods && sim.now - oneshot_mods_time >= ONESHOT_TIMEOUT) {
+    clear_oneshot_mods();
+  }
+#endif
+#if defined(LEADER_ENABLE)
+  leader_task();
+#endif
+#if defined(CAPS_WORD_ENABLE) && CAPS_WORD_IDLE_TIMEOUT > 0
+  if (caps_word_active && sim.now - caps_word_time >= CAPS_WORD_IDLE_TIMEOUT) {
+    caps_word_off();
+  }
+#endif
+
+  matrix_scan_user();
+  housekeeping_task_user();
+  rgb_matrix_task();
+}
+
+void sim_advance_to(uint32_t time) {
+  while (sim.now < time) {
+    sim.now++;
+    sim_scan();
+  }
+}
+
+void sim_reset(void) {
+  if (!timing_overhead_ns) {
+    calibrate_timing();
+  }
+  sim_hook_stats_t hooks[SIM_HOOK_COUNT];
+  memcpy(hooks, sim.hooks, sizeof(hooks));
+  memset(&sim, 0, sizeof(sim));
+  memcpy(sim.hooks, hooks, sizeof(hooks));
+  sim.led_hash = 0xcbf29ce484222325ULL;
+
+  layer_state = 0;
+  keyboard_config     = (keyboard_config_t){0};
+  rawhid_state        = (rawhid_state_t){0};
+  rgb_matrix_config   = (rgb_config_t){
+      .enable = 1,
+      .mode   = 1,
+      .hsv    = {0, 255, RGB_MATRIX_MAXIMUM_BRIGHTNESS},
+#if defined(RGB_MATRIX_STARTUP_SPD)
+      .speed = RGB_MATRIX_STARTUP_SPD,
+#else
+      .speed = 127,
+#endif
+      .flags = LED_FLAG_ALL,
+  };
+
+  real_mods = weak_mods = oneshot_mods = 0;
+  sent_mods                            = 0;
+  memset(report_keys, 0, sizeof(report_keys));
+  memset(sent_keys, 0, sizeof(sent_keys));
+  memset(host_slot, 0, sizeof(host_slot));
+  memset(source_layers, 0, sizeof(source_layers));
+  memset(tapped_down, 0, sizeof(tapped_down));
+  ko_suppressed_mods  = 0;
+  oneshot_layer_state = 0;
+  rgb_frame_time      = 0;
+  tapping_phase       = TAPPING_IDLE;
+  waiting_buffer_head = waiting_buffer_tail = 0;
+#if defined(CAPS_WORD_ENABLE)
+  caps_word_active = false;
+#endif
+#if defined(LEADER_ENABLE)
+  leading = false;
+#endif
+#if defined(KEY_OVERRIDE_ENABLE)
+  active_override = NULL;
+#endif
+#if defined(REPEAT_KEY_ENABLE)
+  last_keycode = repeating_keycode = 0;
+  last_mods                        = 0;
+#endif
+#if defined(COMBO_ENABLE)
+  combo_buffer_size = 0;
+  combo_term        = 0;
+  active_combo      = NULL;
+#endif
+
+  rgb_matrix_saved = rgb_matrix_config;
+  eeconfig_user    = 0;
+#if defined(EECONFIG_USER_DATA_SIZE) && EECONFIG_USER_DATA_SIZE > 0
+  memset(eeconfig_user_data, 0, sizeof(eeconfig_user_data));
+#endif
+  eeconfig_init_user();
+
+  // Boot restores the default layer through the normal path, so layouts that
+  // track it in default_layer_state_set_user start from a known state.
+  default_layer_set(1);
+  host_driver = &sim_driver;
+  keyboard_post_init_user();
+}
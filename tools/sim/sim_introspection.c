@@ -0,0 +1,39 @@
+// Compiles the layout's keymap.c and exposes its tables to the simulated
+// core, the same way quantum/keymap_introspection.c does in the firmware.
+
+#include "keymap.c"
+
+#include "sim_introspection.h"
+
+// Weak like their QMK counterparts, so a layout may store its layers
+// differently.
+__attribute__((weak)) uint8_t keymap_layer_count(void) {
+  return ARRAY_SIZE(keymaps);
+}
+
+__attribute__((weak)) uint16_t keycode_at_keymap_location(uint8_t layer, uint8_t row, uint8_t column) {
+  if (layer < keymap_layer_count() && row < MATRIX_ROWS && column < MATRIX_COLS) {
+    return pgm_read_word(&keymaps[layer][row][column]);
+  }
+  return KC_TRANSPARENT;
+}
+
+#if defined(COMBO_ENABLE)
+uint16_t combo_count(void) {
+  return ARRAY_SIZE(key_combos);
+}
+
+combo_t *combo_get(uint16_t combo_idx) {
+  return &key_combos[combo_idx];
+}
+#endif
+
+#if defined(KEY_OVERRIDE_ENABLE)
+uint16_t key_override_count(void) {
+  return ARRAY_SIZE(key_overrides);
+}
+
+const key_override_t *key_override_get(uint16_t key_override_idx) {
+  return key_overrides[key_override_idx];
+}
+#endif
@@ -0,0 +1,16 @@
+#pragma once
+
+#include QMK_KEYBOARD_H
+
+uint8_t  keymap_layer_count(void);
+uint16_t keycode_at_keymap_location(uint8_t layer, uint8_t row, uint8_t column);
+
+#if defined(COMBO_ENABLE)
+uint16_t combo_count(void);
+combo_t *combo_get(uint16_t combo_idx);
+#endif
+
+#if defined(KEY_OVERRIDE_ENABLE)
+uint16_t              key_override_count(void);
+const key_override_t *key_override_get(uint16_t key_override_idx);
+#endif
@@ -0,0 +1,406 @@
+// Replays recorded key traces through the simulated core and reports what
+// the host would have seen, which hold/tap decisions were made and what each
+// event cost on the host CPU.
+//
+// Trace format, one event per line:
+//
+//   <time_ms> <down|up> <key>
+//   <time_ms> hid <byte>...
+//
+// where <key> is a Voyager slot name (k00..k51, see
+// vrMEr/visualization-method.md) or a raw matrix position "r<row>c<col>",
+// and a hid line delivers one raw HID packet (hex bytes, zero padded) from
+// the host.
+// Blank lines and lines starting with '#' are ignored.
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim.h"
+
+#define MAX_EVENTS 65536
+#define TRACE_TAIL_MS 1000
+
+typedef struct {
+  uint32_t time;
+  keypos_t key;
+  bool     pressed;
+  bool     hid;
+  uint8_t  data[RAW_EPSIZE];
+} trace_event_t;
+
+static trace_event_t events[MAX_EVENTS];
+static uint32_t      event_count;
+
+static bool opt_reports;
+static bool opt_decisions;
+static bool opt_no_cost;
+static int  opt_iterations = 1;
+
+static const char *slot_name(keypos_t key) {
+  static char buf[16];
+  if (key.row == KEYLOC_COMBO) {
+    return "combo";
+  }
+  for (int i = 0; i < VOYAGER_SLOT_COUNT; i++) {
+    if (voyager_slot_pos[i].row == key.row && voyager_slot_pos[i].col == key.col) {
+      snprintf(buf, sizeof(buf), "k%02d", i);
+      return buf;
+    }
+  }
+  snprintf(buf, sizeof(buf), "r%uc%u", key.row, key.col);
+  return buf;
+}
+
+static bool parse_key(const char *name, keypos_t *key) {
+  unsigned a, b;
+  char     extra;
+  if (sscanf(name, "k%u%c", &a, &extra) == 1 && a < VOYAGER_SLOT_COUNT) {
+    *key = voyager_slot_pos[a];
+    return true;
+  }
+  if (sscanf(name, "r%uc%u%c", &a, &b, &extra) == 2 && a < MATRIX_ROWS && b < MATRIX_COLS) {
+    *key = (keypos_t){.row = (uint8_t)a, .col = (uint8_t)b};
+    return true;
+  }
+  return false;
+}
+
+static bool parse_hid(const char *p, uint8_t *data) {
+  int count = 0;
+  for (;;) {
+    unsigned byte;
+    int      used;
+    if (sscanf(p, "%x%n", &byte, &used) != 1) {
+      break;
+    }
+    if (byte > 0xff || count == RAW_EPSIZE) {
+      return false;
+    }
+    data[count++] = (uint8_t)byte;
+    p += used;
+  }
+  while (*p == ' ' || *p == '\t') {
+    p++;
+  }
+  return count > 0 && (*p == '\n' || *p == '\0' || *p == '#');
+}
+
+static bool load_trace(const char *path) {
+  FILE *f = fopen(path, "r");
+  if (!f) {
+    fprintf(stderr, "%s: %s\n", path, strerror(errno));
+    return false;
+  }
+  char     line[256];
+  unsigned lineno = 0;
+  uint32_t last   = 0;
+  event_count     = 0;
+  while (fgets(line, sizeof(line), f)) {
+    lineno++;
+    char *p = line;
+    while (*p == ' ' || *p == '\t') {
+      p++;
+    }
+    if (*p == '#' || *p == '\n' || *p == '\0') {
+      continue;
+    }
+    unsigned long  time;
+    char           action[8], key[16];
+    int            used;
+    trace_event_t *ev = &events[event_count];
+    *ev               = (trace_event_t){0};
+    if (sscanf(p, "%lu %7s %n", &time, action, &used) != 2) {
+      fprintf(stderr, "%s:%u: expected '<time_ms> <down|up> <key>'\n", path, lineno);
+      fclose(f);
+      return false;
+    }
+    if (!strcmp(action, "hid")) {
+      ev->hid = true;
+      if (!parse_hid(p + used, ev->data)) {
+        fprintf(stderr, "%s:%u: expected up to %d hex bytes after 'hid'\n", path, lineno, RAW_EPSIZE);
+        fclose(f);
+        return false;
+      }
+    } else {
+      if (sscanf(p + used, "%15s", key) != 1) {
+        fprintf(stderr, "%s:%u: expected '<time_ms> <down|up> <key>'\n", path, lineno);
+        fclose(f);
+        return false;
+      }
+      if (!parse_key(key, &ev->key)) {
+        fprintf(stderr, "%s:%u: unknown key '%s'\n", path, lineno, key);
+        fclose(f);
+        return false;
+      }
+      if (!strcmp(action, "down") || !strcmp(action, "d")) {
+        ev->pressed = true;
+      } else if (!strcmp(action, "up") || !strcmp(action, "u")) {
+        ev->pressed = false;
+      } else {
+        fprintf(stderr, "%s:%u: unknown action '%s'\n", path, lineno, action);
+        fclose(f);
+        return false;
+      }
+    }
+    if (time < last) {
+      fprintf(stderr, "%s:%u: time goes backwards\n", path, lineno);
+      fclose(f);
+      return false;
+    }
+    ev->time = last = (uint32_t)time;
+    if (++event_count == MAX_EVENTS) {
+      fprintf(stderr, "%s: more than %d events\n", path, MAX_EVENTS);
+      fclose(f);
+      return false;
+    }
+  }
+  fclose(f);
+  return true;
+}
+
+typedef struct {
+  uint64_t ns_total;
+  uint64_t ns_max;
+  uint64_t instructions_total;
+  uint64_t scan_ns_total;
+} replay_cost_t;
+
+// Events are stamped one millisecond after the scan that sees them, so a
+// trace starting at 0 still runs the first scan with an idle matrix.
+static void replay(replay_cost_t *cost) {
+  sim_reset();
+  for (uint32_t i = 0; i < event_count; i++) {
+    uint64_t t0 = sim_clock_ns();
+    sim_advance_to(events[i].time + 1);
+    cost->scan_ns_total += sim_clock_ns() - t0;
+
+    if (events[i].hid) {
+      // Host requests are not key events; keep them out of the cost figures.
+      uint8_t data[RAW_EPSIZE];
+      memcpy(data, events[i].data, sizeof(data));
+      sim_rawhid_log_received(data, sizeof(data));
+      raw_hid_receive(data, sizeof(data));
+      continue;
+    }
+    uint64_t i0 = sim_counter_read();
+    t0          = sim_clock_ns();
+    sim_matrix_event(events[i].key, events[i].pressed);
+    uint64_t ns = sim_clock_ns() - t0;
+    cost->instructions_total += sim_counter_read() - i0;
+    cost->ns_total += ns;
+    if (ns > cost->ns_max) {
+      cost->ns_max = ns;
+    }
+  }
+  uint64_t t0 = sim_clock_ns();
+  sim_advance_to(sim.now + TRACE_TAIL_MS);
+  cost->scan_ns_total += sim_clock_ns() - t0;
+}
+
+static void print_report(const sim_report_t *r) {
+  printf("  %7u ms  host %7u ms  (+%3u)  ", r->time, r->host_time, r->host_time - r->origin);
+  if (r->kind == SIM_REPORT_CONSUMER) {
+    printf("consumer %04x\n", r->usage);
+    return;
+  }
+  if (r->kind == SIM_REPORT_MOUSE) {
+    printf("mouse buttons %02x x %4d y %4d v %4d h %4d\n", r->mouse.buttons, r->mouse.x, r->mouse.y, r->mouse.v, r->mouse.h);
+    return;
+  }
+  printf("mods %02x keys", r->mods);
+  for (int k = 0; k < 6; k++) {
+    printf(" %02x", r->keys[k]);
+  }
+  printf("\n");
+}
+
+static void print_rawhid(const sim_rawhid_t *m) {
+  int len = RAW_EPSIZE;
+  while (len > 1 && !m->data[len - 1]) {
+    len--;
+  }
+  printf("  %7u ms  raw hid %s", m->time, m->to_host ? "<-" : "->");
+  for (int i = 0; i < len; i++) {
+    printf(" %02x", m->data[i]);
+  }
+  printf("\n");
+}
+
+static const char *reason_name(sim_decision_reason_t reason) {
+  switch (reason) {
+    case SIM_DECIDED_BY_RELEASE:
+      return "release";
+    case SIM_DECIDED_BY_TERM:
+      return "term";
+    case SIM_DECIDED_BY_OTHER_KEY:
+      return "other key";
+    case SIM_DECIDED_BY_SAME_HAND:
+      return "same hand";
+    case SIM_DECIDED_BY_NESTED_TAP:
+      return "nested tap";
+  }
+  return "?";
+}
+
+static void print_summary(const char *path, const replay_cost_t *cost, bool have_counter) {
+  uint32_t keyboard = 0, consumer = 0, mouse = 0;
+  int32_t  moved[4]      = {0};
+  uint64_t latency_total = 0;
+  uint32_t latency_max   = 0;
+  for (uint32_t i = 0; i < sim.report_count; i++) {
+    const sim_report_t *r = &sim.reports[i];
+    if (r->kind == SIM_REPORT_MOUSE) {
+      // Movement keeps going after the key event, so it has no latency.
+      mouse++;
+      moved[0] += r->mouse.x;
+      moved[1] += r->mouse.y;
+      moved[2] += r->mouse.v;
+      moved[3] += r->mouse.h;
+      continue;
+    }
+    if (r->kind == SIM_REPORT_KEYBOARD) {
+      keyboard++;
+    } else {
+      consumer++;
+    }
+    uint32_t latency = r->host_time - r->origin;
+    latency_total += latency;
+    if (latency > latency_max) {
+      latency_max = latency;
+    }
+  }
+  uint32_t taps = 0, holds = 0, by_term = 0, by_other = 0, by_nested = 0, same_hand = 0;
+  for (uint32_t i = 0; i < sim.decision_count; i++) {
+    const sim_decision_t *d = &sim.decisions[i];
+    if (d->hold) {
+      holds++;
+      by_term += d->reason == SIM_DECIDED_BY_TERM;
+      by_other += d->reason == SIM_DECIDED_BY_OTHER_KEY;
+      by_nested += d->reason == SIM_DECIDED_BY_NESTED_TAP;
+    } else {
+      taps++;
+      same_hand += d->reason == SIM_DECIDED_BY_SAME_HAND;
+    }
+  }
+  uint64_t runs = (uint64_t)opt_iterations * (event_count ? event_count : 1);
+
+  printf("%s: %u events over %u ms\n", path, event_count, event_count ? events[event_count - 1].time : 0);
+  if (opt_reports) {
+    for (uint32_t i = 0; i < sim.report_count; i++) {
+      print_report(&sim.reports[i]);
+    }
+    for (uint32_t i = 0; i < sim.rawhid_count; i++) {
+      print_rawhid(&sim.rawhid[i]);
+    }
+  }
+  if (opt_decisions) {
+    for (uint32_t i = 0; i < sim.decision_count; i++) {
+      const sim_decision_t *d = &sim.decisions[i];
+      printf("  %7u ms  %-5s %04x  %-4s after %3u ms of %u (%s)\n", d->press_time, slot_name(d->key), d->keycode, d->hold ? "hold" : "tap", d->decide_time - d->press_time, d->term, reason_name(d->reason));
+    }
+  }
+  printf("  hid reports     %u keyboard, %u consumer\n", keyboard, consumer);
+  if (keyboard + consumer) {
+    printf("  report latency  avg %.1f ms, max %u ms (key event to host poll)\n", (double)latency_total / (keyboard + consumer), latency_max);
+  }
+  if (mouse) {
+    printf("  mouse           %u reports, moved x %d y %d, wheel v %d h %d\n", mouse, moved[0], moved[1], moved[2], moved[3]);
+  }
+  printf("  hold/tap        %u tap (%u early, same hand), %u hold (%u by term, %u by other key, %u by nested tap)\n", taps, same_hand, holds, by_term, by_other, by_nested);
+  printf("  combos          %u fired, %llu key checks, %u ms buffered\n", sim.combos_fired, (unsigned long long)sim.combo_checks, sim.combo_buffered_ms);
+  printf("  rgb frames      %u, %u led writes, output hash %016llx\n", sim.rgb_frames, sim.led_writes, (unsigned long long)sim.led_hash);
+  if (sim.eeprom_writes) {
+    printf("  eeprom          %u user data writes, %u bytes changed\n", sim.eeprom_writes, sim.eeprom_bytes);
+  }
+  if (opt_no_cost) {
+    return;
+  }
+  printf("  event cost      avg %llu ns, max %llu ns", (unsigned long long)(cost->ns_total / runs), (unsigned long long)cost->ns_max);
+  if (have_counter) {
+    printf(", %llu instructions", (unsigned long long)(cost->instructions_total / runs));
+  }
+  printf("\n");
+  printf("  scan cost       avg %llu ns per 1 ms scan\n", (unsigned long long)(cost->scan_ns_total / ((uint64_t)opt_iterations * (sim.now ? sim.now : 1))));
+
+  printf("  %-28s %10s %9s %9s %12s\n", "hook", "calls", "avg ns", "max ns", "instr/call");
+  for (int h = 0; h < SIM_HOOK_COUNT; h++) {
+    const sim_hook_stats_t *s = &sim.hooks[h];
+    if (!s->calls) {
+      continue;
+    }
+    printf("  %-28s %10llu %9llu %9llu", sim_hook_name((sim_hook_t)h), (unsigned long long)(s->calls / opt_iterations), (unsigned long long)(s->ns_total / s->calls), (unsigned long long)s->ns_max);
+    if (have_counter) {
+      printf(" %12llu", (unsigned long long)(s->instructions_total / s->calls));
+    } else {
+      printf(" %12s", "n/a");
+    }
+    printf("\n");
+  }
+}
+
+static void usage(const char *argv0) {
+  fprintf(stderr,
+          "usage: %s [-r] [-d] [-c] [-n iterations] trace...\n"
+          "  -r  print every HID report and raw HID packet\n"
+          "  -d  print every hold/tap decision\n"
+          "  -c  leave out the cost figures, which differ from run to run\n"
+          "  -n  replay each trace n times and average the cost figures\n",
+          argv0);
+}
+
+int main(int argc, char **argv) {
+  int argi = 1;
+  for (; argi < argc && argv[argi][0] == '-'; argi++) {
+    const char *opt = argv[argi];
+    if (!strcmp(opt, "-r")) {
+      opt_reports = true;
+    } else if (!strcmp(opt, "-d")) {
+      opt_decisions = true;
+    } else if (!strcmp(opt, "-c")) {
+      opt_no_cost = true;
+    } else if (!strcmp(opt, "-n") && argi + 1 < argc) {
+      opt_iterations = atoi(argv[++argi]);
+      if (opt_iterations < 1) {
+        opt_iterations = 1;
+      }
+    } else {
+      usage(argv[0]);
+      return 2;
+    }
+  }
+  if (argi == argc) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  sim_state_t *first = malloc(sizeof(sim_state_t));
+  if (!first) {
+    perror("malloc");
+    return 1;
+  }
+  bool have_counter = sim_counter_open();
+  int  status       = 0;
+  for (; argi < argc; argi++) {
+    if (!load_trace(argv[argi])) {
+      status = 1;
+      continue;
+    }
+    replay_cost_t cost = {0};
+    memset(sim.hooks, 0, sizeof(sim.hooks));
+    replay(&cost);
+    // Layout code may keep its own statics, so only the first replay starts
+    // from a freshly booted state. Report what it did; later replays only
+    // add to the cost figures.
+    memcpy(first, &sim, sizeof(sim));
+    for (int i = 1; i < opt_iterations; i++) {
+      replay(&cost);
+    }
+    memcpy(first->hooks, sim.hooks, sizeof(sim.hooks));
+    memcpy(&sim, first, sizeof(sim));
+    print_summary(argv[argi], &cost, have_counter);
+  }
+  return status;
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "quantum.h"
+
+// Debounce interface (quantum/debounce.h). The simulator feeds key events
+// straight in, so a layout's custom debounce is built but not called; host
+// tests in test/ call it with synthetic matrix rows.
+bool debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed);
+void debounce_init(uint8_t num_rows);
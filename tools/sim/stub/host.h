@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stdint.h>
+
+// Host driver (tmk_core/protocol/host.h). Reports leave the core through the
+// current driver, which layout code may wrap.
+typedef struct {
+  uint8_t mods;
+  uint8_t reserved;
+  uint8_t keys[6];
+} report_keyboard_t;
+
+typedef struct report_nkro_t report_nkro_t;
+
+typedef struct {
+  uint8_t buttons;
+  int8_t  x;
+  int8_t  y;
+  int8_t  v;
+  int8_t  h;
+} report_mouse_t;
+
+typedef struct {
+  uint8_t  report_id;
+  uint16_t usage;
+} report_extra_t;
+
+typedef struct {
+  uint8_t (*keyboard_leds)(void);
+  void (*send_keyboard)(report_keyboard_t *);
+  void (*send_nkro)(report_nkro_t *);
+  void (*send_mouse)(report_mouse_t *);
+  void (*send_extra)(report_extra_t *);
+} host_driver_t;
+
+host_driver_t *host_get_driver(void);
+void           host_set_driver(host_driver_t *driver);
+void           host_mouse_send(report_mouse_t *report);
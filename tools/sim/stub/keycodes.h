@@ -0,0 +1,295 @@
+#pragma once
+
+// Subset of quantum/keycodes.h and quantum/keycode.h used by the layouts in
+// this repository. Values match upstream QMK so range checks and keycode
+// arithmetic behave exactly as they do in the firmware.
+
+// Basic HID usages.
+enum sim_basic_keycodes {
+  KC_NO = 0x0000,
+  KC_TRANSPARENT = 0x0001,
+  KC_A = 0x0004, KC_B, KC_C, KC_D, KC_E, KC_F, KC_G, KC_H, KC_I, KC_J, KC_K, KC_L, KC_M,
+  KC_N, KC_O, KC_P, KC_Q, KC_R, KC_S, KC_T, KC_U, KC_V, KC_W, KC_X, KC_Y, KC_Z,
+  KC_1 = 0x001E, KC_2, KC_3, KC_4, KC_5, KC_6, KC_7, KC_8, KC_9, KC_0,
+  KC_ENTER = 0x0028,
+  KC_ESCAPE,
+  KC_BACKSPACE,
+  KC_TAB,
+  KC_SPACE,
+  KC_MINUS,
+  KC_EQUAL,
+  KC_LEFT_BRACKET,
+  KC_RIGHT_BRACKET,
+  KC_BACKSLASH,
+  KC_NONUS_HASH,
+  KC_SEMICOLON,
+  KC_QUOTE,
+  KC_GRAVE,
+  KC_COMMA,
+  KC_DOT,
+  KC_SLASH,
+  KC_CAPS_LOCK,
+  KC_F1 = 0x003A, KC_F2, KC_F3, KC_F4, KC_F5, KC_F6, KC_F7, KC_F8, KC_F9, KC_F10, KC_F11, KC_F12,
+  KC_PRINT_SCREEN = 0x0046,
+  KC_SCROLL_LOCK,
+  KC_PAUSE,
+  KC_INSERT,
+  KC_HOME,
+  KC_PAGE_UP,
+  KC_DELETE,
+  KC_END,
+  KC_PAGE_DOWN,
+  KC_RIGHT,
+  KC_LEFT,
+  KC_DOWN,
+  KC_UP,
+  KC_NONUS_BACKSLASH = 0x0064,
+  KC_APPLICATION,
+  KC_F13 = 0x0068, KC_F14, KC_F15, KC_F16, KC_F17, KC_F18, KC_F19, KC_F20, KC_F21, KC_F22, KC_F23, KC_F24,
+  KC_AUDIO_MUTE = 0x00A8,
+  KC_AUDIO_VOL_UP,
+  KC_AUDIO_VOL_DOWN,
+  KC_MEDIA_NEXT_TRACK,
+  KC_MEDIA_PREV_TRACK,
+  KC_MEDIA_STOP,
+  KC_MEDIA_PLAY_PAUSE,
+  KC_MS_UP = 0x00CD,
+  KC_MS_DOWN,
+  KC_MS_LEFT,
+  KC_MS_RIGHT,
+  KC_MS_BTN1,
+  KC_MS_BTN2,
+  KC_MS_BTN3,
+  KC_MS_BTN4,
+  KC_MS_BTN5,
+  KC_MS_BTN6,
+  KC_MS_BTN7,
+  KC_MS_BTN8,
+  KC_MS_WH_UP,
+  KC_MS_WH_DOWN,
+  KC_MS_WH_LEFT,
+  KC_MS_WH_RIGHT,
+  KC_MS_ACCEL0,
+  KC_MS_ACCEL1,
+  KC_MS_ACCEL2,
+  KC_LEFT_CTRL = 0x00E0,
+  KC_LEFT_SHIFT,
+  KC_LEFT_ALT,
+  KC_LEFT_GUI,
+  KC_RIGHT_CTRL,
+  KC_RIGHT_SHIFT,
+  KC_RIGHT_ALT,
+  KC_RIGHT_GUI,
+};
+
+#define KC_TRNS KC_TRANSPARENT
+#define XXXXXXX KC_NO
+#define _______ KC_TRANSPARENT
+#define KC_ENT KC_ENTER
+#define KC_ESC KC_ESCAPE
+#define KC_BSPC KC_BACKSPACE
+#define KC_SPC KC_SPACE
+#define KC_MINS KC_MINUS
+#define KC_EQL KC_EQUAL
+#define KC_LBRC KC_LEFT_BRACKET
+#define KC_RBRC KC_RIGHT_BRACKET
+#define KC_BSLS KC_BACKSLASH
+#define KC_NUHS KC_NONUS_HASH
+#define KC_SCLN KC_SEMICOLON
+#define KC_QUOT KC_QUOTE
+#define KC_GRV KC_GRAVE
+#define KC_COMM KC_COMMA
+#define KC_SLSH KC_SLASH
+#define KC_CAPS KC_CAPS_LOCK
+#define KC_PSCR KC_PRINT_SCREEN
+#define KC_INS KC_INSERT
+#define KC_PGUP KC_PAGE_UP
+#define KC_DEL KC_DELETE
+#define KC_PGDN KC_PAGE_DOWN
+#define KC_RGHT KC_RIGHT
+#define KC_NUBS KC_NONUS_BACKSLASH
+#define KC_APP KC_APPLICATION
+#define KC_MUTE KC_AUDIO_MUTE
+#define KC_VOLU KC_AUDIO_VOL_UP
+#define KC_VOLD KC_AUDIO_VOL_DOWN
+#define KC_MNXT KC_MEDIA_NEXT_TRACK
+#define KC_MPRV KC_MEDIA_PREV_TRACK
+#define KC_MSTP KC_MEDIA_STOP
+#define KC_MPLY KC_MEDIA_PLAY_PAUSE
+#define KC_MS_U KC_MS_UP
+#define KC_MS_D KC_MS_DOWN
+#define KC_MS_L KC_MS_LEFT
+#define KC_MS_R KC_MS_RIGHT
+#define KC_BTN1 KC_MS_BTN1
+#define KC_BTN2 KC_MS_BTN2
+#define KC_BTN3 KC_MS_BTN3
+#define KC_WH_U KC_MS_WH_UP
+#define KC_WH_D KC_MS_WH_DOWN
+#define KC_WH_L KC_MS_WH_LEFT
+#define KC_WH_R KC_MS_WH_RIGHT
+// QMK 0.27 names.
+#define QK_MOUSE_CURSOR_UP KC_MS_UP
+#define QK_MOUSE_CURSOR_DOWN KC_MS_DOWN
+#define QK_MOUSE_CURSOR_LEFT KC_MS_LEFT
+#define QK_MOUSE_CURSOR_RIGHT KC_MS_RIGHT
+#define QK_MOUSE_WHEEL_UP KC_MS_WH_UP
+#define QK_MOUSE_WHEEL_DOWN KC_MS_WH_DOWN
+#define QK_MOUSE_WHEEL_LEFT KC_MS_WH_LEFT
+#define QK_MOUSE_WHEEL_RIGHT KC_MS_WH_RIGHT
+#define QK_MOUSE_ACCELERATION_0 KC_MS_ACCEL0
+#define QK_MOUSE_ACCELERATION_1 KC_MS_ACCEL1
+#define QK_MOUSE_ACCELERATION_2 KC_MS_ACCEL2
+#define KC_LCTL KC_LEFT_CTRL
+#define KC_LSFT KC_LEFT_SHIFT
+#define KC_LALT KC_LEFT_ALT
+#define KC_LGUI KC_LEFT_GUI
+#define KC_RCTL KC_RIGHT_CTRL
+#define KC_RSFT KC_RIGHT_SHIFT
+#define KC_RALT KC_RIGHT_ALT
+#define KC_RGUI KC_RIGHT_GUI
+
+#define IS_BASIC_KEYCODE(kc) ((kc) >= KC_A && (kc) <= KC_EXSEL_END)
+#define KC_EXSEL_END 0x00A4
+#define IS_CONSUMER_KEYCODE(kc) ((kc) >= KC_AUDIO_MUTE && (kc) <= KC_MEDIA_PLAY_PAUSE)
+#define IS_MOUSE_KEYCODE(kc) ((kc) >= KC_MS_UP && (kc) <= KC_MS_ACCEL2)
+#define IS_MODIFIER_KEYCODE(kc) ((kc) >= KC_LEFT_CTRL && (kc) <= KC_RIGHT_GUI)
+
+// Quantum keycode ranges.
+#define QK_BASIC 0x0000
+#define QK_BASIC_MAX 0x00FF
+#define QK_MODS 0x0100
+#define QK_MODS_MAX 0x1FFF
+#define QK_MOD_TAP 0x2000
+#define QK_MOD_TAP_MAX 0x3FFF
+#define QK_LAYER_TAP 0x4000
+#define QK_LAYER_TAP_MAX 0x4FFF
+#define QK_TO 0x5200
+#define QK_TO_MAX 0x521F
+#define QK_MOMENTARY 0x5220
+#define QK_MOMENTARY_MAX 0x523F
+#define QK_DEF_LAYER 0x5240
+#define QK_DEF_LAYER_MAX 0x525F
+#define QK_TOGGLE_LAYER 0x5260
+#define QK_TOGGLE_LAYER_MAX 0x527F
+#define QK_ONE_SHOT_LAYER 0x5280
+#define QK_ONE_SHOT_LAYER_MAX 0x529F
+#define QK_ONE_SHOT_MOD 0x52A0
+#define QK_ONE_SHOT_MOD_MAX 0x52BF
+#define QK_LIGHTING 0x7800
+#define QK_LIGHTING_MAX 0x78FF
+#define QK_QUANTUM 0x7C00
+#define QK_QUANTUM_MAX 0x7DFF
+#define QK_KB 0x7E00
+#define QK_KB_MAX 0x7E3F
+#define QK_USER 0x7E40
+#define QK_USER_MAX 0x7FFF
+
+#define IS_QK_BASIC(kc) ((kc) <= QK_BASIC_MAX)
+#define IS_QK_MODS(kc) ((kc) >= QK_MODS && (kc) <= QK_MODS_MAX)
+#define IS_QK_MOD_TAP(kc) ((kc) >= QK_MOD_TAP && (kc) <= QK_MOD_TAP_MAX)
+#define IS_QK_LAYER_TAP(kc) ((kc) >= QK_LAYER_TAP && (kc) <= QK_LAYER_TAP_MAX)
+#define IS_QK_TO(kc) ((kc) >= QK_TO && (kc) <= QK_TO_MAX)
+#define IS_QK_MOMENTARY(kc) ((kc) >= QK_MOMENTARY && (kc) <= QK_MOMENTARY_MAX)
+#define IS_QK_DEF_LAYER(kc) ((kc) >= QK_DEF_LAYER && (kc) <= QK_DEF_LAYER_MAX)
+#define IS_QK_TOGGLE_LAYER(kc) ((kc) >= QK_TOGGLE_LAYER && (kc) <= QK_TOGGLE_LAYER_MAX)
+#define IS_QK_ONE_SHOT_LAYER(kc) ((kc) >= QK_ONE_SHOT_LAYER && (kc) <= QK_ONE_SHOT_LAYER_MAX)
+#define IS_QK_ONE_SHOT_MOD(kc) ((kc) >= QK_ONE_SHOT_MOD && (kc) <= QK_ONE_SHOT_MOD_MAX)
+#define IS_QK_LIGHTING(kc) ((kc) >= QK_LIGHTING && (kc) <= QK_LIGHTING_MAX)
+#define IS_QK_KB(kc) ((kc) >= QK_KB && (kc) <= QK_KB_MAX)
+#define IS_QK_USER(kc) ((kc) >= QK_USER && (kc) <= QK_USER_MAX)
+
+#define SAFE_RANGE QK_USER
+
+// 5-bit modifier encoding used inside keycodes.
+#define MOD_LCTL 0x01
+#define MOD_LSFT 0x02
+#define MOD_LALT 0x04
+#define MOD_LGUI 0x08
+#define MOD_RCTL 0x11
+#define MOD_RSFT 0x12
+#define MOD_RALT 0x14
+#define MOD_RGUI 0x18
+#define MOD_HYPR 0x0F
+#define MOD_MEH 0x07
+
+// 8-bit HID modifier encoding used by get_mods()/add_mods().
+#define MOD_BIT(kc) (1 << ((kc) & 0x07))
+#define MOD_BIT_LCTRL MOD_BIT(KC_LEFT_CTRL)
+#define MOD_BIT_LSHIFT MOD_BIT(KC_LEFT_SHIFT)
+#define MOD_BIT_LALT MOD_BIT(KC_LEFT_ALT)
+#define MOD_BIT_LGUI MOD_BIT(KC_LEFT_GUI)
+#define MOD_BIT_RCTRL MOD_BIT(KC_RIGHT_CTRL)
+#define MOD_BIT_RSHIFT MOD_BIT(KC_RIGHT_SHIFT)
+#define MOD_BIT_RALT MOD_BIT(KC_RIGHT_ALT)
+#define MOD_BIT_RGUI MOD_BIT(KC_RIGHT_GUI)
+#define MOD_MASK_CTRL (MOD_BIT_LCTRL | MOD_BIT_RCTRL)
+#define MOD_MASK_SHIFT (MOD_BIT_LSHIFT | MOD_BIT_RSHIFT)
+#define MOD_MASK_ALT (MOD_BIT_LALT | MOD_BIT_RALT)
+#define MOD_MASK_GUI (MOD_BIT_LGUI | MOD_BIT_RGUI)
+#define MOD_MASK_CS (MOD_MASK_CTRL | MOD_MASK_SHIFT)
+
+// Modified keycodes.
+#define LCTL(kc) (0x0100 | (kc))
+#define LSFT(kc) (0x0200 | (kc))
+#define LALT(kc) (0x0400 | (kc))
+#define LGUI(kc) (0x0800 | (kc))
+#define RCTL(kc) (0x1100 | (kc))
+#define RSFT(kc) (0x1200 | (kc))
+#define RALT(kc) (0x1400 | (kc))
+#define RGUI(kc) (0x1800 | (kc))
+#define S(kc) LSFT(kc)
+#define ALGR(kc) RALT(kc)
+#define LCMD(kc) LGUI(kc)
+#define LOPT(kc) LALT(kc)
+
+#define QK_MODS_GET_MODS(kc) (((kc) >> 8) & 0x1F)
+#define QK_MODS_GET_BASIC_KEYCODE(kc) ((kc) & 0xFF)
+
+// Tap-hold, layer and one-shot keycodes.
+#define MT(mod, kc) (QK_MOD_TAP | (((mod) & 0x1F) << 8) | ((kc) & 0xFF))
+#define LT(layer, kc) (QK_LAYER_TAP | (((layer) & 0xF) << 8) | ((kc) & 0xFF))
+#define TO(layer) (QK_TO | ((layer) & 0x1F))
+#define MO(layer) (QK_MOMENTARY | ((layer) & 0x1F))
+#define DF(layer) (QK_DEF_LAYER | ((layer) & 0x1F))
+#define TG(layer) (QK_TOGGLE_LAYER | ((layer) & 0x1F))
+#define OSL(layer) (QK_ONE_SHOT_LAYER | ((layer) & 0x1F))
+#define OSM(mod) (QK_ONE_SHOT_MOD | ((mod) & 0x1F))
+
+#define QK_MOD_TAP_GET_MODS(kc) (((kc) >> 8) & 0x1F)
+#define QK_MOD_TAP_GET_TAP_KEYCODE(kc) ((kc) & 0xFF)
+#define QK_LAYER_TAP_GET_LAYER(kc) (((kc) >> 8) & 0xF)
+#define QK_LAYER_TAP_GET_TAP_KEYCODE(kc) ((kc) & 0xFF)
+#define QK_TO_GET_LAYER(kc) ((kc) & 0x1F)
+#define QK_MOMENTARY_GET_LAYER(kc) ((kc) & 0x1F)
+#define QK_DEF_LAYER_GET_LAYER(kc) ((kc) & 0x1F)
+#define QK_TOGGLE_LAYER_GET_LAYER(kc) ((kc) & 0x1F)
+#define QK_ONE_SHOT_LAYER_GET_LAYER(kc) ((kc) & 0x1F)
+#define QK_ONE_SHOT_MOD_GET_MODS(kc) ((kc) & 0x1F)
+
+// Lighting keycodes.
+enum sim_lighting_keycodes {
+  RGB_TOG = 0x7820,
+  RGB_MODE_FORWARD,
+  RGB_MODE_REVERSE,
+  RGB_HUI,
+  RGB_HUD,
+  RGB_SAI,
+  RGB_SAD,
+  RGB_VAI,
+  RGB_VAD,
+  RGB_SPI,
+  RGB_SPD,
+};
+#define RGB_MOD RGB_MODE_FORWARD
+
+// Quantum keycodes.
+enum sim_quantum_keycodes {
+  QK_BOOT = 0x7C00,
+  QK_LEADER = 0x7C58,
+  QK_CAPS_WORD_TOGGLE = 0x7C73,
+  QK_REPEAT_KEY = 0x7C79,
+  QK_ALT_REPEAT_KEY = 0x7C7A,
+};
+#define QK_LEAD QK_LEADER
+#define CW_TOGG QK_CAPS_WORD_TOGGLE
+#define QK_REP QK_REPEAT_KEY
@@ -0,0 +1,370 @@
+#pragma once
+
+// Host-side stand-in for the parts of quantum/quantum.h that the layouts in
+// this repository use. Only declarations live here; sim_core.c provides the
+// behaviour. Anything not listed is deliberately absent so that a layout
+// reaching for a new QMK API fails to build on the host instead of silently
+// diverging from the firmware.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "keycodes.h"
+
+#ifndef MATRIX_ROWS
+#    error "MATRIX_ROWS must be defined by the keyboard header"
+#endif
+
+#if MATRIX_COLS <= 8
+typedef uint8_t matrix_row_t;
+#elif MATRIX_COLS <= 16
+typedef uint16_t matrix_row_t;
+#else
+typedef uint32_t matrix_row_t;
+#endif
+
+#define PROGMEM
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+#define pgm_read_word(p) (*(const uint16_t *)(p))
+#define pgm_read_dword(p) (*(const uint32_t *)(p))
+#define pgm_read_ptr(p) (*(void *const *)(p))
+#define memcpy_P memcpy
+
+#ifndef ARRAY_SIZE
+#    define ARRAY_SIZE(a) (sizeof(a) / sizeof((a)[0]))
+#endif
+#ifndef MIN
+#    define MIN(x, y) ((x) < (y) ? (x) : (y))
+#endif
+#ifndef MAX
+#    define MAX(x, y) ((x) > (y) ? (x) : (y))
+#endif
+
+// Defaults from quantum/action_tapping.h and friends.
+#ifndef TAPPING_TERM
+#    define TAPPING_TERM 200
+#endif
+#ifndef QUICK_TAP_TERM
+#    define QUICK_TAP_TERM TAPPING_TERM
+#endif
+#ifndef COMBO_TERM
+#    define COMBO_TERM 50
+#endif
+#ifndef ONESHOT_TIMEOUT
+#    define ONESHOT_TIMEOUT 0
+#endif
+#ifndef LEADER_TIMEOUT
+#    define LEADER_TIMEOUT 300
+#endif
+#ifndef CAPS_WORD_IDLE_TIMEOUT
+#    define CAPS_WORD_IDLE_TIMEOUT 5000
+#endif
+#ifndef USB_POLLING_INTERVAL_MS
+#    define USB_POLLING_INTERVAL_MS 1
+#endif
+#ifndef RGB_MATRIX_LED_FLUSH_LIMIT
+#    define RGB_MATRIX_LED_FLUSH_LIMIT 16
+#endif
+#ifndef RGB_MATRIX_VAL_STEP
+#    define RGB_MATRIX_VAL_STEP 16
+#endif
+#ifndef RGB_MATRIX_HUE_STEP
+#    define RGB_MATRIX_HUE_STEP 8
+#endif
+#ifndef RGB_MATRIX_SAT_STEP
+#    define RGB_MATRIX_SAT_STEP 16
+#endif
+#ifndef RGB_MATRIX_SPD_STEP
+#    define RGB_MATRIX_SPD_STEP 16
+#endif
+#ifndef RGB_MATRIX_MAXIMUM_BRIGHTNESS
+#    define RGB_MATRIX_MAXIMUM_BRIGHTNESS 255
+#endif
+
+// Layers.
+#if defined(LAYER_STATE_8BIT)
+typedef uint8_t layer_state_t;
+#    define MAX_LAYER 8
+#elif defined(LAYER_STATE_16BIT)
+typedef uint16_t layer_state_t;
+#    define MAX_LAYER 16
+#else
+typedef uint32_t layer_state_t;
+#    define MAX_LAYER 32
+#endif
+
+extern layer_state_t layer_state;
+extern layer_state_t default_layer_state;
+
+void          layer_state_set(layer_state_t state);
+void          layer_clear(void);
+void          layer_move(uint8_t layer);
+void          layer_on(uint8_t layer);
+void          layer_off(uint8_t layer);
+void          layer_invert(uint8_t layer);
+bool          layer_state_is(uint8_t layer);
+bool          layer_state_cmp(layer_state_t state, uint8_t layer);
+void          default_layer_set(layer_state_t state);
+uint8_t       get_highest_layer(layer_state_t state);
+uint8_t       biton16(uint16_t bits);
+uint8_t       biton32(uint32_t bits);
+layer_state_t layer_state_set_user(layer_state_t state);
+layer_state_t default_layer_state_set_user(layer_state_t state);
+
+#define IS_LAYER_ON(layer) layer_state_is(layer)
+#define IS_LAYER_OFF(layer) (!layer_state_is(layer))
+
+// Key events.
+typedef struct {
+  uint8_t col;
+  uint8_t row;
+} keypos_t;
+
+typedef enum {
+  TICK_EVENT  = 0,
+  KEY_EVENT   = 1,
+  COMBO_EVENT = 4,
+} keyevent_type_t;
+
+typedef struct {
+  keypos_t        key;
+  uint16_t        time;
+  keyevent_type_t type;
+  bool            pressed;
+} keyevent_t;
+
+typedef struct {
+  bool    interrupted : 1;
+  bool    reserved2 : 1;
+  bool    reserved1 : 1;
+  bool    reserved0 : 1;
+  uint8_t count : 4;
+} tap_t;
+
+typedef struct {
+  keyevent_t event;
+  tap_t      tap;
+  uint16_t   keycode;
+} keyrecord_t;
+
+#define KEYLOC_COMBO 254
+
+uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t key);
+uint8_t  read_source_layers_cache(keypos_t key);
+
+// Timers. The simulator clock only advances between scans.
+uint16_t timer_read(void);
+uint32_t timer_read32(void);
+uint16_t timer_elapsed(uint16_t last);
+uint32_t timer_elapsed32(uint32_t last);
+void     wait_ms(uint16_t ms);
+#define TIMER_DIFF_16(a, b) ((uint16_t)((a) - (b)))
+
+#include "host.h"
+#include "raw_hid.h"
+
+// Mouse keys: buttons only, movement is left to the layout.
+report_mouse_t mousekey_get_report(void);
+
+// Keyboard report and modifiers.
+void    register_code(uint8_t code);
+void    unregister_code(uint8_t code);
+void    tap_code(uint8_t code);
+void    register_code16(uint16_t code);
+void    unregister_code16(uint16_t code);
+void    tap_code16(uint16_t code);
+void    register_mods(uint8_t mods);
+void    add_key(uint8_t code);
+void    del_key(uint8_t code);
+uint8_t extract_mod_bits(uint16_t code);
+void    unregister_mods(uint8_t mods);
+uint8_t get_mods(void);
+void    add_mods(uint8_t mods);
+void    del_mods(uint8_t mods);
+void    set_mods(uint8_t mods);
+void    clear_mods(void);
+uint8_t get_weak_mods(void);
+void    add_weak_mods(uint8_t mods);
+void    del_weak_mods(uint8_t mods);
+void    clear_weak_mods(void);
+uint8_t get_oneshot_mods(void);
+bool    is_oneshot_layer_active(void);
+void    add_oneshot_mods(uint8_t mods);
+void    set_oneshot_mods(uint8_t mods);
+void    clear_oneshot_mods(void);
+void    send_keyboard_report(void);
+void    clear_keyboard(void);
+
+// User and keyboard hooks. Weak defaults live in sim_core.c, as in QMK.
+bool     pre_process_record_kb(uint16_t keycode, keyrecord_t *record);
+bool     pre_process_record_user(uint16_t keycode, keyrecord_t *record);
+bool     process_record_kb(uint16_t keycode, keyrecord_t *record);
+bool     process_record_user(uint16_t keycode, keyrecord_t *record);
+void     post_process_record_user(uint16_t keycode, keyrecord_t *record);
+uint16_t get_tapping_term(uint16_t keycode, keyrecord_t *record);
+uint16_t get_quick_tap_term(uint16_t keycode, keyrecord_t *record);
+bool     get_hold_on_other_key_press(uint16_t keycode, keyrecord_t *record);
+bool     get_permissive_hold(uint16_t keycode, keyrecord_t *record);
+
+// Chordal Hold (quantum/action_tapping.h).
+extern const char chordal_hold_layout[MATRIX_ROWS][MATRIX_COLS];
+char              chordal_hold_handedness(keypos_t key);
+bool              get_chordal_hold(uint16_t tap_hold_keycode, keyrecord_t *tap_hold_record, uint16_t other_keycode, keyrecord_t *other_record);
+bool              get_chordal_hold_default(keyrecord_t *tap_hold_record, keyrecord_t *other_record);
+void     keyboard_post_init_user(void);
+void     matrix_scan_user(void);
+void     housekeeping_task_user(void);
+
+// Combos.
+#define COMBO_END 0
+
+typedef struct {
+  const uint16_t *keys;
+  uint16_t        keycode;
+  uint16_t        state;
+  bool            disabled;
+  bool            active;
+} combo_t;
+
+#define COMBO(ck, ca) { .keys = &(ck)[0], .keycode = (ca) }
+
+uint16_t get_combo_term(uint16_t combo_index, combo_t *combo);
+bool     combo_should_trigger(uint16_t combo_index, combo_t *combo, uint16_t keycode, keyrecord_t *record);
+
+// Key overrides.
+typedef enum {
+  ko_option_activation_trigger_down          = (1 << 0),
+  ko_option_activation_required_mod_down     = (1 << 1),
+  ko_option_activation_negative_mod_up       = (1 << 2),
+  ko_option_one_mod                          = (1 << 3),
+  ko_option_no_reregister_trigger            = (1 << 4),
+  ko_option_no_unregister_on_other_key_down  = (1 << 5),
+  ko_options_all_activations                 = ko_option_activation_negative_mod_up | ko_option_activation_required_mod_down | ko_option_activation_trigger_down,
+  ko_options_default                         = ko_options_all_activations,
+} ko_option_t;
+
+typedef struct {
+  uint16_t      trigger;
+  uint8_t       trigger_mods;
+  layer_state_t layers;
+  uint8_t       negative_mod_mask;
+  uint8_t       suppressed_mods;
+  uint16_t      replacement;
+  ko_option_t   options;
+  bool (*custom_action)(bool activated, void *context);
+  void *context;
+  bool *enabled;
+} key_override_t;
+
+#define ko_make_basic(trigger_mods_, trigger_key, replacement_key) \
+  ((const key_override_t){ \
+    .trigger_mods      = (trigger_mods_), \
+    .layers            = (layer_state_t)~0, \
+    .suppressed_mods   = (trigger_mods_), \
+    .options           = ko_options_default, \
+    .negative_mod_mask = 0, \
+    .custom_action     = NULL, \
+    .context           = NULL, \
+    .trigger           = (trigger_key), \
+    .replacement       = (replacement_key), \
+    .enabled           = NULL, \
+  })
+
+// Leader key.
+bool leader_sequence_active(void);
+bool leader_sequence_one_key(uint16_t kc);
+bool leader_sequence_two_keys(uint16_t kc1, uint16_t kc2);
+bool leader_sequence_three_keys(uint16_t kc1, uint16_t kc2, uint16_t kc3);
+void leader_start_user(void);
+void leader_end_user(void);
+bool leader_add_user(uint16_t keycode);
+
+// Caps word and repeat key.
+bool     is_caps_word_on(void);
+void     caps_word_on(void);
+void     caps_word_off(void);
+bool     caps_word_press_user(uint16_t keycode);
+uint16_t get_last_keycode(void);
+uint8_t  get_last_mods(void);
+void     set_last_keycode(uint16_t keycode);
+void     set_last_mods(uint8_t mods);
+
+// Colour.
+typedef struct {
+  uint8_t h;
+  uint8_t s;
+  uint8_t v;
+} hsv_t;
+
+typedef struct {
+  uint8_t r;
+  uint8_t g;
+  uint8_t b;
+} rgb_t;
+
+typedef hsv_t HSV;
+typedef rgb_t RGB;
+
+rgb_t hsv_to_rgb(hsv_t hsv);
+
+// RGB matrix.
+typedef uint8_t led_flags_t;
+#define LED_FLAG_NONE 0x00
+#define LED_FLAG_ALL 0xFF
+
+typedef struct {
+  uint8_t     enable;
+  uint8_t     mode;
+  hsv_t       hsv;
+  uint8_t     speed;
+  led_flags_t flags;
+} rgb_config_t;
+
+// Effect ids the layouts refer to; the simulator renders every effect as
+// solid colour.
+enum rgb_matrix_effects {
+  RGB_MATRIX_NONE = 0,
+  RGB_MATRIX_SOLID_COLOR,
+};
+
+void        rgb_matrix_enable(void);
+void        rgb_matrix_enable_noeeprom(void);
+void        rgb_matrix_disable(void);
+void        rgb_matrix_disable_noeeprom(void);
+void        rgb_matrix_toggle(void);
+bool        rgb_matrix_is_enabled(void);
+void        rgb_matrix_mode(uint8_t mode);
+void        rgb_matrix_mode_noeeprom(uint8_t mode);
+void        rgb_matrix_reload_from_eeprom(void);
+void        rgb_matrix_sethsv(uint8_t hue, uint8_t sat, uint8_t val);
+void        rgb_matrix_set_color(int index, uint8_t red, uint8_t green, uint8_t blue);
+void        rgb_matrix_set_color_all(uint8_t red, uint8_t green, uint8_t blue);
+led_flags_t rgb_matrix_get_flags(void);
+uint8_t     rgb_matrix_get_val(void);
+bool        rgb_matrix_indicators_kb(void);
+bool        rgb_matrix_indicators_user(void);
+
+// RGB matrix builds alias the rgblight API.
+#define rgblight_mode rgb_matrix_mode
+#define rgblight_sethsv rgb_matrix_sethsv
+
+// User word of the EEPROM config (quantum/eeconfig.h). Starts at 0 like a
+// freshly initialised EEPROM; eeconfig_init_user runs at every reset.
+uint32_t eeconfig_read_user(void);
+void     eeconfig_update_user(uint32_t val);
+void     eeconfig_init_user(void);
+
+// User datablock (EECONFIG_USER_DATA_SIZE bytes), zeroed at every reset.
+void eeconfig_read_user_datablock(void *data, uint32_t offset, uint32_t length);
+void eeconfig_update_user_datablock(const void *data, uint32_t offset, uint32_t length);
+
+// Oryx module state.
+typedef struct {
+  bool paired;
+  bool rgb_control;
+  bool status_led_control;
+} rawhid_state_t;
+
+extern rawhid_state_t rawhid_state;
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "usb_descriptor.h"
+
+// Raw HID (quantum/raw_hid.h). The simulator records what the keyboard sends.
+void raw_hid_send(uint8_t *data, uint8_t length);
+void raw_hid_receive(uint8_t *data, uint8_t length);
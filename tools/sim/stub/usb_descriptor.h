@@ -0,0 +1,4 @@
+#pragma once
+
+// Endpoint sizes (tmk_core/protocol/usb_descriptor.h).
+#define RAW_EPSIZE 32
@@ -0,0 +1,4 @@
+#pragma once
+
+#define QMK_VERSION "sim"
+#define QMK_BUILDDATE "sim"
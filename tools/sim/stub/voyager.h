@@ -0,0 +1,61 @@
+#pragma once
+
+// Host-side stand-in for keyboards/zsa/voyager/voyager.h. The matrix is the
+// Voyager's 12x7 split matrix: rows 0-5 are the left half, rows 6-11 the
+// right half. Slot names k00..k51 follow vrMEr/visualization-method.md.
+
+#define MATRIX_ROWS 12
+#define MATRIX_COLS 7
+#define RGB_MATRIX_LED_COUNT 52
+#define VOYAGER_SLOT_COUNT 52
+
+#include "quantum.h"
+
+#define LAYOUT_voyager( \
+    k00, k01, k02, k03, k04, k05, k26, k27, k28, k29, k30, k31, \
+    k06, k07, k08, k09, k10, k11, k32, k33, k34, k35, k36, k37, \
+    k12, k13, k14, k15, k16, k17, k38, k39, k40, k41, k42, k43, \
+    k18, k19, k20, k21, k22, k23, k44, k45, k46, k47, k48, k49, \
+    k24, k25, k50, k51 \
+) { \
+    { KC_NO, k00, k01, k02, k03, k04, k05 }, \
+    { KC_NO, k06, k07, k08, k09, k10, k11 }, \
+    { KC_NO, k12, k13, k14, k15, k16, k17 }, \
+    { KC_NO, k18, k19, k20, k21, k22, k23 }, \
+    { KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO }, \
+    { k24, k25, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO }, \
+    { k26, k27, k28, k29, k30, k31, KC_NO }, \
+    { k32, k33, k34, k35, k36, k37, KC_NO }, \
+    { k38, k39, k40, k41, k42, k43, KC_NO }, \
+    { k44, k45, k46, k47, k48, k49, KC_NO }, \
+    { KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO }, \
+    { KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, k50, k51 } \
+}
+#define LAYOUT LAYOUT_voyager
+
+// Matrix position of each slot, indexed by slot number. The simulator uses it
+// to translate kNN names in traces; LED indices use the same numbering.
+static const keypos_t voyager_slot_pos[VOYAGER_SLOT_COUNT] = {
+    {.row = 0, .col = 1}, {.row = 0, .col = 2}, {.row = 0, .col = 3}, {.row = 0, .col = 4}, {.row = 0, .col = 5}, {.row = 0, .col = 6},
+    {.row = 1, .col = 1}, {.row = 1, .col = 2}, {.row = 1, .col = 3}, {.row = 1, .col = 4}, {.row = 1, .col = 5}, {.row = 1, .col = 6},
+    {.row = 2, .col = 1}, {.row = 2, .col = 2}, {.row = 2, .col = 3}, {.row = 2, .col = 4}, {.row = 2, .col = 5}, {.row = 2, .col = 6},
+    {.row = 3, .col = 1}, {.row = 3, .col = 2}, {.row = 3, .col = 3}, {.row = 3, .col = 4}, {.row = 3, .col = 5}, {.row = 3, .col = 6},
+    {.row = 5, .col = 0}, {.row = 5, .col = 1}, {.row = 6, .col = 0}, {.row = 6, .col = 1}, {.row = 6, .col = 2}, {.row = 6, .col = 3},
+    {.row = 6, .col = 4}, {.row = 6, .col = 5}, {.row = 7, .col = 0}, {.row = 7, .col = 1}, {.row = 7, .col = 2}, {.row = 7, .col = 3},
+    {.row = 7, .col = 4}, {.row = 7, .col = 5}, {.row = 8, .col = 0}, {.row = 8, .col = 1}, {.row = 8, .col = 2}, {.row = 8, .col = 3},
+    {.row = 8, .col = 4}, {.row = 8, .col = 5}, {.row = 9, .col = 0}, {.row = 9, .col = 1}, {.row = 9, .col = 2}, {.row = 9, .col = 3},
+    {.row = 9, .col = 4}, {.row = 9, .col = 5}, {.row = 11, .col = 5}, {.row = 11, .col = 6},
+};
+
+// Keyboard-level keycodes provided by the ZSA keyboard code.
+enum voyager_keycodes {
+  TOGGLE_LAYER_COLOR = QK_KB,
+  LED_LEVEL,
+};
+
+typedef struct {
+  bool disable_layer_led;
+  bool led_level;
+} keyboard_config_t;
+
+extern keyboard_config_t keyboard_config;
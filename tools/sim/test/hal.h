@@ -0,0 +1,35 @@
+#pragma once
+
+// Stand-in for the part of ChibiOS's I2C driver that vrmer_expander.c uses
+// for its combined transfers. The expander test defines the calls over its
+// model.
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef int32_t  msg_t;
+typedef uint32_t sysinterval_t;
+
+#define MSG_OK      ((msg_t)0)
+#define MSG_TIMEOUT ((msg_t)-1)
+#define MSG_RESET   ((msg_t)-2)
+
+#define TIME_MS2I(ms) ((sysinterval_t)(ms))
+
+typedef enum {
+  I2C_UNINIT,
+  I2C_STOP,
+  I2C_READY,
+  I2C_ACTIVE_TX,
+  I2C_ACTIVE_RX,
+  I2C_LOCKED,
+} i2cstate_t;
+
+typedef struct {
+  i2cstate_t state;
+} I2CDriver;
+
+extern I2CDriver I2CD1;
+
+msg_t i2cMasterTransmitTimeout(I2CDriver *i2cp, uint8_t addr, const uint8_t *txbuf, size_t txbytes, uint8_t *rxbuf, size_t rxbytes, sysinterval_t timeout);
+void  i2cStop(I2CDriver *i2cp);
@@ -0,0 +1,15 @@
+#pragma once
+
+// Stand-in for drivers/gpio/mcp23018.h: the two calls keyboards/zsa/voyager
+// matrix.c makes. The expander test defines them over its model.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef enum {
+  mcp23018_PORTA,
+  mcp23018_PORTB,
+} mcp23018_port_t;
+
+bool mcp23018_set_output_all(uint8_t slave_addr, uint8_t confA, uint8_t confB);
+bool mcp23018_read_pins(uint8_t slave_addr, mcp23018_port_t port, uint8_t *ret);
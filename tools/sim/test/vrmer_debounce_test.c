@@ -0,0 +1,127 @@
+// Host test of the custom debounce (vrMEr/vrmer_debounce.c).
+//
+// The simulator feeds key events in after the matrix, so debounce() never
+// runs in a trace. This calls it the way quantum/matrix_common.c does, with
+// synthetic raw rows on a clock of its own, and checks what reaches the
+// cooked matrix. vrmer_debounce_test_zero.c runs it again with DEBOUNCE 0.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "vrmer_debounce.c"
+
+static uint16_t     now;
+static matrix_row_t raw[MATRIX_ROWS];
+static matrix_row_t last_raw[MATRIX_ROWS];
+static matrix_row_t cooked[MATRIX_ROWS];
+
+uint16_t timer_read(void) {
+  return now;
+}
+
+#define EXPECT(cond)                                                                \
+  do {                                                                              \
+    if (!(cond)) {                                                                  \
+      fprintf(stderr, "%s:%d: at %u ms: %s\n", __FILE__, __LINE__, now, #cond);     \
+      exit(1);                                                                      \
+    }                                                                               \
+  } while (0)
+
+// One matrix scan at time t with row 0 reading keys closed; returns whether
+// the cooked matrix changed.
+static bool scan(uint16_t t, matrix_row_t keys) {
+  now        = t;
+  raw[0]     = keys;
+  bool changed = memcmp(raw, last_raw, sizeof(raw)) != 0;
+  memcpy(last_raw, raw, sizeof(raw));
+  return debounce(raw, cooked, MATRIX_ROWS, changed);
+}
+
+static void start(uint16_t t) {
+  now = t;
+  memset(raw, 0, sizeof(raw));
+  memset(last_raw, 0, sizeof(last_raw));
+  memset(cooked, 0, sizeof(cooked));
+  debounce_init(MATRIX_ROWS);
+  bounce_total = 0;
+  memset(bounces, 0, sizeof(bounces));
+}
+
+// Press at t, release at t + 20: the press is reported on the scan that sees
+// it, the release DEBOUNCE ms after the key first read open.
+static void press_and_release(uint16_t t) {
+  start(t - 1);
+  EXPECT(!scan(t - 1, 0));
+  EXPECT(scan(t, 1));
+  EXPECT(cooked[0] == 1);
+  EXPECT(!scan(t + 1, 1));
+
+  uint16_t open = t + 20;
+  for (int ms = 0; ms < DEBOUNCE; ms++) {
+    EXPECT(!scan(open + ms, 0));
+    EXPECT(cooked[0] == 1);
+  }
+  EXPECT(scan(open + DEBOUNCE, 0));
+  EXPECT(cooked[0] == 0);
+  EXPECT(!any_pending);
+  EXPECT(bounce_total == 0);
+}
+
+// A key reading closed again inside the window keeps the press and counts a
+// bounce; the release after it starts a new window.
+static void bounce(void) {
+#if DEBOUNCE >= 2
+  start(0);
+  EXPECT(scan(0, 1));
+  EXPECT(!scan(10, 0));
+  EXPECT(!scan(10 + DEBOUNCE - 1, 1));
+  EXPECT(cooked[0] == 1);
+  EXPECT(bounce_total == 1 && bounces[0][0] == 1);
+
+  EXPECT(!scan(30, 0));
+  EXPECT(!scan(30 + DEBOUNCE - 1, 0));
+  EXPECT(scan(30 + DEBOUNCE, 0));
+  EXPECT(cooked[0] == 0);
+  EXPECT(bounce_total == 1);
+#endif
+}
+
+// Each key keeps its own window: a second key pressed while the first one's
+// release is pending is reported at once, and releasing it does not move the
+// first one's release.
+static void two_keys(void) {
+#if DEBOUNCE >= 2
+  start(0);
+  EXPECT(scan(0, 1));
+  EXPECT(!scan(10, 0));
+  EXPECT(scan(11, 2));
+  EXPECT(cooked[0] == 3);
+  EXPECT(scan(10 + DEBOUNCE, 2));
+  EXPECT(cooked[0] == 2);
+  EXPECT(!scan(20, 0));
+  EXPECT(!scan(19 + DEBOUNCE, 0));
+  EXPECT(scan(20 + DEBOUNCE, 0));
+  EXPECT(cooked[0] == 0);
+#endif
+}
+
+// No scan for far longer than DEBOUNCE, or than the 8-bit countdown step:
+// the release is reported on the next scan.
+static void long_gap(void) {
+  start(0);
+  EXPECT(scan(0, 1));
+  scan(10, 0);
+  EXPECT(cooked[0] == (DEBOUNCE ? 1 : 0));
+  scan(1010, 0);
+  EXPECT(cooked[0] == 0);
+}
+
+int main(void) {
+  press_and_release(100);
+  // timer_read wraps between the release and its report.
+  press_and_release(0xFFFF - 20 - DEBOUNCE / 2);
+  bounce();
+  two_keys();
+  long_gap();
+  return 0;
+}
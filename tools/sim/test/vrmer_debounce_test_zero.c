@@ -0,0 +1,6 @@
+// vrmer_debounce_test.c with DEBOUNCE 0: releases are reported on the scan
+// that sees them, like presses.
+
+#define DEBOUNCE 0
+
+#include "vrmer_debounce_test.c"
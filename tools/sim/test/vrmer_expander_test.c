@@ -0,0 +1,214 @@
+// Host test of the change-driven right-half scan (vrMEr/vrmer_expander.c).
+//
+// On the keyboard the module sits between keyboards/zsa/voyager/matrix.c and
+// the MCP23018 driver through -Wl,--wrap. Here the loop below, shaped like
+// matrix.c's right-half loop, calls the __wrap_ functions directly, and the
+// __real_ ones and the ChibiOS transfer act on a model of the expander that
+// counts I2C transactions and can fail them. vrmer_expander_test_direct.c
+// runs it again without the combined transfers.
+
+#include <hal.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef VRMER_EXPANDER_BATCH
+#    define VRMER_EXPANDER_BATCH 1
+#endif
+
+#include "vrmer_expander.c"
+
+#define ADDRESS 0x20 // MCP23018_DEFAULT_ADDRESS, as matrix.c passes it
+#define COLS    7
+
+#define EXPECT(cond)                                                 \
+  do {                                                               \
+    if (!(cond)) {                                                   \
+      fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond);     \
+      exit(1);                                                       \
+    }                                                                \
+  } while (0)
+
+/* ---------------------------------------------------------------------------
+ * Expander model
+ */
+
+I2CDriver I2CD1 = {I2C_READY};
+
+static uint8_t olat_a, olat_b;
+static uint8_t keys[COLS]; // row bits of the keys down per column
+static int     transactions;
+static int     fail; // transactions to fail from now on
+
+static bool transaction(void) {
+  transactions++;
+  if (fail) {
+    fail--;
+    return false;
+  }
+  return true;
+}
+
+// Rows read low for keys down in a selected (low) column; bits 6 and 7 are
+// outputs and read back their latch.
+static uint8_t gpiob(void) {
+  uint8_t value = VRMER_EXPANDER_ROWS | (olat_b & 0xC0);
+  for (uint8_t col = 0; col < COLS; col++) {
+    if (!(olat_a & (1 << col))) {
+      value &= ~keys[col];
+    }
+  }
+  return value;
+}
+
+bool __real_mcp23018_set_output_all(uint8_t slave_addr, uint8_t confA, uint8_t confB) {
+  EXPECT(slave_addr == ADDRESS);
+  if (!transaction()) {
+    return false;
+  }
+  olat_a = confA;
+  olat_b = confB;
+  return true;
+}
+
+bool __real_mcp23018_read_pins(uint8_t slave_addr, mcp23018_port_t port, uint8_t *ret) {
+  EXPECT(slave_addr == ADDRESS);
+  if (!transaction()) {
+    return false;
+  }
+  *ret = port == mcp23018_PORTB ? gpiob() : olat_a;
+  return true;
+}
+
+msg_t i2cMasterTransmitTimeout(I2CDriver *i2cp, uint8_t addr, const uint8_t *txbuf, size_t txbytes, uint8_t *rxbuf, size_t rxbytes, sysinterval_t timeout) {
+  EXPECT(i2cp->state == I2C_READY);
+  EXPECT(addr == ADDRESS && txbytes == 2 && txbuf[0] == MCP23018_GPIOA && rxbytes == 1);
+  if (!transaction()) {
+    return MSG_TIMEOUT;
+  }
+  olat_a = txbuf[1];
+  *rxbuf = gpiob();
+  return MSG_OK;
+}
+
+void i2cStop(I2CDriver *i2cp) {
+  i2cp->state = I2C_STOP;
+}
+
+/* ---------------------------------------------------------------------------
+ * matrix.c
+ */
+
+static bool         leds[3];
+static int          errors; // mcp23018_errors
+static matrix_row_t right[COLS];
+
+bool __real_matrix_scan_custom(matrix_row_t current_matrix[]) {
+  bool changed = false;
+  for (uint8_t col = 0; col < COLS; col++) {
+    uint8_t rows = 0;
+    if (!errors) {
+      errors += !__wrap_mcp23018_set_output_all(ADDRESS, (0x7F & ~(1 << col)) | ((uint8_t)!leds[2] << 7), ((uint8_t)!leds[1] << 6) | ((uint8_t)!leds[0] << 7));
+    }
+    if (!errors) {
+      uint8_t rx;
+      errors += !__wrap_mcp23018_read_pins(ADDRESS, mcp23018_PORTB, &rx);
+      rows = ~rx & VRMER_EXPANDER_ROWS;
+    }
+    if (right[col] != rows) {
+      right[col] = rows;
+      changed    = true;
+    }
+  }
+  return changed;
+}
+
+// One scan; returns its I2C transactions. The ChibiOS driver is started
+// again by QMK's own calls, as after a timeout on the keyboard.
+static int scan(void) {
+  transactions = 0;
+  __wrap_matrix_scan_custom(NULL);
+  if (I2CD1.state == I2C_STOP) {
+    I2CD1.state = I2C_READY;
+  }
+  return transactions;
+}
+
+// Transactions of a full scan: a select and a read per column, or one
+// combined transfer per column once port B is latched.
+#define FULL (VRMER_EXPANDER_BATCH ? COLS : 2 * COLS)
+
+int main(void) {
+  // The first scans are full; the one that finds every key up latches all
+  // columns selected.
+  EXPECT(scan() >= FULL);
+  EXPECT(idle);
+  for (int i = 0; i < 3; i++) {
+    EXPECT(scan() == 1);
+  }
+
+  // A press is found in the scan that reads it, then scans are full while
+  // it is held.
+  keys[3] = 1 << 2;
+  EXPECT(scan() == 1 + FULL);
+  EXPECT(right[3] == 1 << 2);
+  EXPECT(scan() == FULL);
+  EXPECT(right[3] == 1 << 2);
+
+  // The release is read by a full scan, which then latches idle again.
+  keys[3] = 0;
+  EXPECT(scan() == FULL + 1);
+  EXPECT(right[3] == 0);
+  EXPECT(scan() == 1);
+
+  // An LED change while idle is latched at once, with every column still
+  // selected.
+  leds[2] = true;
+  EXPECT(scan() == 2);
+  EXPECT(olat_a == 0x00);
+  leds[0] = true;
+  EXPECT(scan() == 2);
+  EXPECT(olat_b == 0x40);
+  EXPECT(scan() == 1);
+  leds[0] = leds[2] = false;
+  EXPECT(scan() == 2);
+  EXPECT(olat_a == 0x80 && olat_b == 0xC0);
+
+  // A failed idle read is retried.
+  fail = 1;
+  EXPECT(scan() == 2);
+  EXPECT(!errors && idle);
+
+  // So is a failed transaction of a full scan, without losing the key.
+  keys[0] = 1;
+  scan();
+  fail = 1;
+  scan();
+  EXPECT(!errors);
+  EXPECT(right[0] == 1);
+  keys[0] = 0;
+  scan();
+  EXPECT(right[0] == 0);
+  scan();
+  EXPECT(scan() == 1);
+
+  // The right half unplugged: once the retries fail the error reaches
+  // matrix.c, which stops talking to the expander.
+  fail = 1000;
+  scan();
+  EXPECT(errors);
+  EXPECT(!idle);
+  EXPECT(scan() == 0);
+
+  // Plugged back in: matrix.c clears its error count and full scans find
+  // the keys again until everything is up.
+  fail   = 0;
+  errors = 0;
+  keys[6] = 1 << 5;
+  scan();
+  EXPECT(right[6] == 1 << 5);
+  keys[6] = 0;
+  scan();
+  EXPECT(right[6] == 0);
+  EXPECT(scan() == 1);
+  return 0;
+}
@@ -0,0 +1,6 @@
+// vrmer_expander_test.c without the combined select-and-read transfers, as
+// built for a platform other than ChibiOS.
+
+#define VRMER_EXPANDER_BATCH 0
+
+#include "vrmer_expander_test.c"
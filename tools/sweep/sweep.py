@@ -0,0 +1,268 @@
+#!/usr/bin/env python3
+"""Sweep hold-tap timing over recorded typing traces.
+
+Each point of the parameter grid is a build of the layout simulator
+(tools/sim) with the grid values forced in after the layout's config.h, so
+the traces run through the same tapping state machine, get_tapping_term,
+QUICK_TAP_TERM, permissive hold, Chordal Hold and one-shot handling as the
+keymap itself. Points are built and replayed in parallel, one per worker.
+
+A grid axis is a config.h macro and its values:
+
+    --grid TAPPING_TERM=130:190:20          130, 150, 170, 190
+    --grid VRMER_HOME_ROW_TERM=180,200,220
+    --grid PERMISSIVE_HOLD_PER_KEY=def,-    defined (empty) or #undef
+
+vrMEr's per-key terms are VRMER_HOME_ROW_TERM (home-row mods) and
+VRMER_THUMB_TERM (the space layer-tap); VRMER_TAPPING_TERM_MIN bounds the
+typing-speed term of vrmer_tapping.h. Without --grid the home-row, thumb and
+other-key terms are swept around their current values.
+
+Traces are simulator traces (`<ms> down|up <key>`, see tools/sim/README.md).
+What a tap-hold press was meant to be is taken from a `tap` or `hold` word
+after the key, which the simulator ignores:
+
+    800  down k10 hold
+    1040 down k32
+
+An untagged press counts as meant to be held if the key stays down for at
+least --hold-ms, else as a tap. Presses the keymap does not resolve as
+tap-hold (a plain key on the active layer) are not scored.
+
+For every point the report gives the misfire rate over the scored presses,
+split into holds nobody wanted (a mod or a layer) and holds that came out as
+taps, and the latency of the keyboard reports from key event to host poll.
+Points no other point beats on both misfires and mean latency are marked
+with `*`; the current configuration is marked with `=`.
+
+Usage:
+    sweep.py <trace>... [--layout DIR] [--grid NAME=VALUES]...
+        [--hold-ms N] [--jobs N] [--top N] [--json] [--keep]
+"""
+
+import argparse
+import itertools
+import json
+import multiprocessing
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.abspath(os.path.join(os.path.dirname(__file__), "..", ".."))
+SIM_DIR = os.path.join(ROOT, "tools", "sim")
+
+DEFAULT_GRID = [
+    "VRMER_HOME_ROW_TERM=160:240:20",
+    "VRMER_THUMB_TERM=190:270:40",
+    "TAPPING_TERM=130:170:20",
+]
+
+TRACE_RE = re.compile(r"^\s*(\d+)\s+(down|d|up|u)\s+(\S+)(?:\s+(tap|hold))?\s*(?:#.*)?$")
+DECISION_RE = re.compile(r"^\s+(\d+) ms\s+(\S+)\s+([0-9a-f]{4})\s+(tap|hold)\s+after\s+(\d+) ms of\s+(\d+)")
+REPORT_RE = re.compile(r"^\s+\d+ ms\s+host\s+\d+ ms\s+\(\+\s*(\d+)\)\s+mods ")
+HEADER_RE = re.compile(r"^(\S.*): \d+ events over \d+ ms$")
+
+
+def key_pos(name):
+    """Matrix position of a trace key, `kNN` (LAYOUT_voyager slot) or `rNcM`."""
+    m = re.fullmatch(r"k(\d+)", name)
+    if m:
+        n = int(m.group(1))
+        # VOYAGER_SLOT() in vrMEr/vrmer_keymap.h.
+        if n < 24:
+            return n // 6, n % 6 + 1
+        if n < 26:
+            return 5, n - 24
+        if n < 50:
+            return 6 + (n - 26) // 6, (n - 26) % 6
+        return 11, n - 45
+    m = re.fullmatch(r"r(\d+)c(\d+)", name)
+    if m:
+        return int(m.group(1)), int(m.group(2))
+    raise ValueError(f"unknown key {name}")
+
+
+def read_trace(path, hold_ms):
+    """Intended outcome of every press: {(time, pos): (intent, tagged)}."""
+    presses, down = {}, {}
+    with open(path) as f:
+        for lineno, line in enumerate(f, 1):
+            line = line.strip()
+            if not line or line.startswith("#") or " hid " in f" {line} ":
+                continue
+            m = TRACE_RE.match(line)
+            if not m:
+                raise ValueError(f"{path}:{lineno}: expected '<ms> down|up <key> [tap|hold]'")
+            t, action, pos, tag = int(m.group(1)), m.group(2)[0], key_pos(m.group(3)), m.group(4)
+            if action == "d":
+                down[pos] = (t, tag)
+            elif pos in down:
+                start, tag = down.pop(pos)
+                intent = tag or ("hold" if t - start >= hold_ms else "tap")
+                presses[(start, pos)] = (intent, tag is not None)
+    for pos, (start, tag) in down.items():
+        presses[(start, pos)] = (tag or "hold", tag is not None)
+    return presses
+
+
+def parse_range(spec):
+    name, _, values = spec.partition("=")
+    if not re.fullmatch(r"[A-Z_][A-Z0-9_]*", name) or not values:
+        raise ValueError(f"bad --grid '{spec}', expected NAME=VALUES")
+    m = re.fullmatch(r"(-?\d+):(-?\d+):(\d+)", values)
+    if m:
+        start, stop, step = map(int, m.groups())
+        if step <= 0 or stop < start:
+            raise ValueError(f"bad range in --grid '{spec}'")
+        return name, [str(v) for v in range(start, stop + 1, step)]
+    return name, values.split(",")
+
+
+def config_header(point):
+    out = ["// Generated by tools/sweep/sweep.py.", "#pragma once"]
+    for name, value in point:
+        out.append(f"#undef {name}")
+        if value == "def":
+            out.append(f"#define {name}")
+        elif value != "-":
+            out.append(f"#define {name} {value}")
+    return "\n".join(out) + "\n"
+
+
+def run_point(task):
+    index, point, layout, traces, work = task
+    build = os.path.join(work, f"p{index}")
+    header = os.path.join(work, f"p{index}.h")
+    with open(header, "w") as f:
+        f.write(config_header(point))
+    make = ["make", "-s", "-C", SIM_DIR, f"LAYOUT={layout}", f"BUILD_DIR={build}"]
+    if point:
+        make.append(f"SIM_CONFIG={header}")
+    done = subprocess.run(make, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True)
+    if done.returncode:
+        return index, point, None, done.stdout
+    done = subprocess.run([os.path.join(build, "sim"), "-r", "-d"] + traces,
+                          stdout=subprocess.PIPE, stderr=subprocess.PIPE, text=True)
+    if done.returncode:
+        return index, point, None, done.stderr
+    return index, point, done.stdout, None
+
+
+def score(output, intents):
+    """Compare the simulator's decisions with the intended outcomes."""
+    r = {"scored": 0, "tagged": 0, "wrong_mod": 0, "wrong_layer": 0, "missed_hold": 0, "latency": []}
+    trace = None
+    for line in output.splitlines():
+        m = HEADER_RE.match(line)
+        if m:
+            trace = intents[m.group(1)]
+            continue
+        m = REPORT_RE.match(line)
+        if m:
+            r["latency"].append(int(m.group(1)))
+            continue
+        m = DECISION_RE.match(line)
+        if not m or trace is None:
+            continue
+        # Decisions carry the press time, one millisecond after the trace's.
+        when, keycode, got = int(m.group(1)) - 1, int(m.group(3), 16), m.group(4)
+        try:
+            pos = key_pos(m.group(2))
+        except ValueError:
+            continue
+        if (when, pos) not in trace:
+            continue
+        want, tagged = trace[(when, pos)]
+        r["scored"] += 1
+        r["tagged"] += tagged
+        if got == want:
+            continue
+        if got == "tap":
+            r["missed_hold"] += 1
+        elif 0x4000 <= keycode < 0x5000:  # QK_LAYER_TAP
+            r["wrong_layer"] += 1
+        else:
+            r["wrong_mod"] += 1
+    lat = sorted(r.pop("latency"))
+    misfires = r["wrong_mod"] + r["wrong_layer"] + r["missed_hold"]
+    r["misfires"] = misfires
+    r["misfire_rate"] = misfires / r["scored"] if r["scored"] else 0.0
+    r["latency_avg"] = sum(lat) / len(lat) if lat else 0.0
+    r["latency_p95"] = lat[min(len(lat) - 1, len(lat) * 95 // 100)] if lat else 0
+    return r
+
+
+def pareto(results):
+    for a in results:
+        a["front"] = not any(
+            (b["misfire_rate"] <= a["misfire_rate"] and b["latency_avg"] <= a["latency_avg"]) and
+            (b["misfire_rate"] < a["misfire_rate"] or b["latency_avg"] < a["latency_avg"])
+            for b in results)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("traces", nargs="+")
+    parser.add_argument("--layout", default="vrMEr", help="layout folder (default vrMEr)")
+    parser.add_argument("--grid", action="append", metavar="NAME=VALUES", help="axis of the parameter grid")
+    parser.add_argument("--hold-ms", type=int, default=250, help="untagged presses this long are meant as holds (default 250)")
+    parser.add_argument("--jobs", type=int, default=os.cpu_count(), help="parallel builds (default: all cores)")
+    parser.add_argument("--top", type=int, default=20, help="rows to print (default 20)")
+    parser.add_argument("--json", action="store_true", help="print every point as JSON")
+    parser.add_argument("--keep", action="store_true", help="keep the build directories")
+    args = parser.parse_args()
+
+    try:
+        axes = [parse_range(spec) for spec in (args.grid or DEFAULT_GRID)]
+        if len({name for name, _ in axes}) != len(axes):
+            raise ValueError("a macro is listed twice in --grid")
+        traces = [os.path.abspath(t) for t in args.traces]
+        intents = {t: read_trace(t, args.hold_ms) for t in traces}
+    except (OSError, ValueError) as e:
+        sys.exit(f"sweep: {e}")
+
+    names = [name for name, _ in axes]
+    points = [()] + [tuple(zip(names, values)) for values in itertools.product(*(v for _, v in axes))]
+    work = tempfile.mkdtemp(prefix="sweep-")
+    tasks = [(i, p, args.layout, traces, work) for i, p in enumerate(points)]
+    print(f"sweep: {len(points) - 1} points plus the current configuration on {args.jobs} workers", file=sys.stderr)
+
+    results = []
+    try:
+        with multiprocessing.Pool(max(1, args.jobs)) as pool:
+            for index, point, output, error in pool.imap_unordered(run_point, tasks):
+                if output is None:
+                    sys.exit(f"sweep: point {dict(point) or 'current'} failed:\n{error}")
+                r = score(output, intents)
+                r["index"] = index
+                r["config"] = dict(point)
+                results.append(r)
+    finally:
+        if not args.keep:
+            shutil.rmtree(work, ignore_errors=True)
+
+    results.sort(key=lambda r: (r["misfire_rate"], r["latency_avg"], r["index"]))
+    pareto(results)
+    if args.json:
+        print(json.dumps(results, indent=2))
+        return
+
+    first = results[0]
+    print(f"{first['scored']} tap-hold presses scored, {first['tagged']} tagged, "
+          f"{first['scored'] - first['tagged']} inferred from --hold-ms {args.hold_ms}")
+    width = [max(len(n), 5) for n in names]
+    print("   " + "  ".join(n.rjust(w) for n, w in zip(names, width)) +
+          "  misfire  wrong mod  wrong layer  missed hold  lat avg  lat p95")
+    for r in results[:args.top] + [r for r in results[args.top:] if r["index"] == 0]:
+        mark = "=" if r["index"] == 0 else "*" if r["front"] else " "
+        cells = [str(r["config"].get(n, "")).rjust(w) for n, w in zip(names, width)]
+        print(f" {mark} " + "  ".join(cells) +
+              f"  {100 * r['misfire_rate']:6.2f}%  {r['wrong_mod']:9}  {r['wrong_layer']:11}  {r['missed_hold']:11}"
+              f"  {r['latency_avg']:5.1f} ms  {r['latency_p95']:4} ms")
+
+
+if __name__ == "__main__":
+    main()
@@ -4,48 +4,35 @@
 #define USB_POLLING_INTERVAL_MS 10
 #define SERIAL_NUMBER "vrMEr/wONV7n"
 #define LAYER_STATE_16BIT
-#define COMBO_COUNT 4
+#define COMBO_TERM_PER_COMBO
+#define COMBO_SHOULD_TRIGGER
+
+// Usage counters, see vrmer_usage.h: 11 tables of 52 16-bit counters (1144
+// bytes). Then two copies of the runtime overrides, see vrmer_overrides.h.
+#define EECONFIG_USER_DATA_SIZE 1884
 
 // Layer optimization timing configuration
 #define TAPPING_TERM 150
 #define TAPPING_TERM_PER_KEY
 #define ONESHOT_TIMEOUT 5000
 #define QUICK_TAP_TERM 100
-#define HOLD_ON_OTHER_KEY_PRESS_PER_KEY
+#define CHORDAL_HOLD
+#define PERMISSIVE_HOLD_PER_KEY
 
 #define RGB_MATRIX_STARTUP_SPD 60
 
-#undef ENABLE_RGB_MATRIX_ALPHAS_MODS
-#undef ENABLE_RGB_MATRIX_GRADIENT_UP_DOWN
-#undef ENABLE_RGB_MATRIX_GRADIENT_LEFT_RIGHT
-#undef ENABLE_RGB_MATRIX_BREATHING
-#undef ENABLE_RGB_MATRIX_BAND_SAT
-#undef ENABLE_RGB_MATRIX_BAND_VAL
-#undef ENABLE_RGB_MATRIX_BAND_PINWHEEL_SAT
-#undef ENABLE_RGB_MATRIX_BAND_PINWHEEL_VAL
-#undef ENABLE_RGB_MATRIX_BAND_SPIRAL_SAT
-#undef ENABLE_RGB_MATRIX_BAND_SPIRAL_VAL
-#undef ENABLE_RGB_MATRIX_CYCLE_ALL
-#undef ENABLE_RGB_MATRIX_CYCLE_LEFT_RIGHT
-#undef ENABLE_RGB_MATRIX_CYCLE_UP_DOWN
-#undef ENABLE_RGB_MATRIX_CYCLE_OUT_IN
-#undef ENABLE_RGB_MATRIX_CYCLE_OUT_IN_DUAL
-#undef ENABLE_RGB_MATRIX_RAINBOW_MOVING_CHEVRON
-#undef ENABLE_RGB_MATRIX_CYCLE_PINWHEEL
-#undef ENABLE_RGB_MATRIX_CYCLE_SPIRAL
-#undef ENABLE_RGB_MATRIX_DUAL_BEACON
-#undef ENABLE_RGB_MATRIX_RAINBOW_BEACON
-#undef ENABLE_RGB_MATRIX_RAINBOW_PINWHEELS
-#undef ENABLE_RGB_MATRIX_RAINDROPS
-#undef ENABLE_RGB_MATRIX_JELLYBEAN_RAINDROPS
-#undef ENABLE_RGB_MATRIX_HUE_BREATHING
-#undef ENABLE_RGB_MATRIX_HUE_PENDULUM
-#undef ENABLE_RGB_MATRIX_HUE_WAVE
-#undef ENABLE_RGB_MATRIX_PIXEL_FRACTAL
-#undef ENABLE_RGB_MATRIX_PIXEL_FLOW
-#undef ENABLE_RGB_MATRIX_PIXEL_RAIN
-#undef ENABLE_RGB_MATRIX_DIGITAL_RAIN
-#undef ENABLE_RGB_MATRIX_MULTISPLASH
+// RGB matrix effects the layout cannot reach, generated by
+// tools/rgbeffects/gen_rgb_effects.py; rerun it after changing RGB keys or
+// the keep lines. The effects kept here can be stored in EEPROM from Oryx
+// and come back with VRMER_PROFILE_RGB_FULL, where RGB_SPD/RGB_SPI/RGB_HUI/
+// RGB_SAI on LAYER_CONFIG adjust them.
+// rgb-effects: keep FLOWER_BLOOMING STARLIGHT STARLIGHT_SMOOTH STARLIGHT_DUAL_HUE
+// rgb-effects: keep STARLIGHT_DUAL_SAT RIVERFLOW TYPING_HEATMAP
+// rgb-effects: keep SOLID_REACTIVE_SIMPLE SOLID_REACTIVE SOLID_REACTIVE_WIDE
+// rgb-effects: keep SOLID_REACTIVE_MULTIWIDE SOLID_REACTIVE_CROSS SOLID_REACTIVE_MULTICROSS
+// rgb-effects: keep SOLID_REACTIVE_NEXUS SOLID_REACTIVE_MULTINEXUS
+// rgb-effects: keep SPLASH SOLID_SPLASH SOLID_MULTISPLASH
+#include "rgb_effects.h"
 
 #define LEADER_PER_KEY_TIMING
 #define LEADER_TIMEOUT 250
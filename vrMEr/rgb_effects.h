@@ -0,0 +1,55 @@
+// Generated by tools/rgbeffects/gen_rgb_effects.py. Do not edit.
+#pragma once
+
+// Effects the layout reaches or keeps, besides RGB_MATRIX_SOLID_COLOR:
+//   FLOWER_BLOOMING            kept in config.h
+//   STARLIGHT                  kept in config.h
+//   STARLIGHT_SMOOTH           kept in config.h
+//   STARLIGHT_DUAL_HUE         kept in config.h
+//   STARLIGHT_DUAL_SAT         kept in config.h
+//   RIVERFLOW                  kept in config.h
+//   TYPING_HEATMAP             kept in config.h
+//   SOLID_REACTIVE_SIMPLE      kept in config.h
+//   SOLID_REACTIVE             kept in config.h
+//   SOLID_REACTIVE_WIDE        kept in config.h
+//   SOLID_REACTIVE_MULTIWIDE   kept in config.h
+//   SOLID_REACTIVE_CROSS       kept in config.h
+//   SOLID_REACTIVE_MULTICROSS  kept in config.h
+//   SOLID_REACTIVE_NEXUS       kept in config.h
+//   SOLID_REACTIVE_MULTINEXUS  kept in config.h
+//   SPLASH                     kept in config.h
+//   SOLID_SPLASH               kept in config.h
+//   SOLID_MULTISPLASH          kept in config.h
+
+// Every other effect is left out of the build.
+#undef ENABLE_RGB_MATRIX_ALPHAS_MODS
+#undef ENABLE_RGB_MATRIX_GRADIENT_UP_DOWN
+#undef ENABLE_RGB_MATRIX_GRADIENT_LEFT_RIGHT
+#undef ENABLE_RGB_MATRIX_BREATHING
+#undef ENABLE_RGB_MATRIX_BAND_SAT
+#undef ENABLE_RGB_MATRIX_BAND_VAL
+#undef ENABLE_RGB_MATRIX_BAND_PINWHEEL_SAT
+#undef ENABLE_RGB_MATRIX_BAND_PINWHEEL_VAL
+#undef ENABLE_RGB_MATRIX_BAND_SPIRAL_SAT
+#undef ENABLE_RGB_MATRIX_BAND_SPIRAL_VAL
+#undef ENABLE_RGB_MATRIX_CYCLE_ALL
+#undef ENABLE_RGB_MATRIX_CYCLE_LEFT_RIGHT
+#undef ENABLE_RGB_MATRIX_CYCLE_UP_DOWN
+#undef ENABLE_RGB_MATRIX_RAINBOW_MOVING_CHEVRON
+#undef ENABLE_RGB_MATRIX_CYCLE_OUT_IN
+#undef ENABLE_RGB_MATRIX_CYCLE_OUT_IN_DUAL
+#undef ENABLE_RGB_MATRIX_CYCLE_PINWHEEL
+#undef ENABLE_RGB_MATRIX_CYCLE_SPIRAL
+#undef ENABLE_RGB_MATRIX_DUAL_BEACON
+#undef ENABLE_RGB_MATRIX_RAINBOW_BEACON
+#undef ENABLE_RGB_MATRIX_RAINBOW_PINWHEELS
+#undef ENABLE_RGB_MATRIX_RAINDROPS
+#undef ENABLE_RGB_MATRIX_JELLYBEAN_RAINDROPS
+#undef ENABLE_RGB_MATRIX_HUE_BREATHING
+#undef ENABLE_RGB_MATRIX_HUE_PENDULUM
+#undef ENABLE_RGB_MATRIX_HUE_WAVE
+#undef ENABLE_RGB_MATRIX_PIXEL_FRACTAL
+#undef ENABLE_RGB_MATRIX_PIXEL_FLOW
+#undef ENABLE_RGB_MATRIX_PIXEL_RAIN
+#undef ENABLE_RGB_MATRIX_DIGITAL_RAIN
+#undef ENABLE_RGB_MATRIX_MULTISPLASH
@@ -9,3 +9,46 @@ COMBO_ENABLE = yes
 REPEAT_KEY_ENABLE = yes
 KEY_OVERRIDE_ENABLE = yes
 LEADER_ENABLE = yes
+# Eager press, deferred release, see vrmer_debounce.h.
+DEBOUNCE_TYPE = custom
+
+SRC += vrmer_tapping.c
+SRC += vrmer_latency.c
+SRC += vrmer_rawhid.c
+SRC += vrmer_profile.c
+SRC += vrmer_keymap.c
+SRC += vrmer_chord.c
+SRC += vrmer_usage.c
+SRC += vrmer_fastpath.c
+SRC += vrmer_telemetry.c
+SRC += vrmer_overrides.c
+SRC += vrmer_debounce.c
+ifeq ($(strip $(MOUSEKEY_ENABLE)), yes)
+  SRC += vrmer_mouse.c
+endif
+
+# Change-driven scan of the right half over I2C, see vrmer_expander.h. Off by
+# default: qmk compile ... -e VRMER_EXPANDER_SCAN=yes
+VRMER_EXPANDER_SCAN ?= no
+ifeq ($(strip $(VRMER_EXPANDER_SCAN)), yes)
+  SRC += vrmer_expander.c
+  EXTRALDFLAGS += -Wl,--wrap=matrix_scan_custom
+  EXTRALDFLAGS += -Wl,--wrap=mcp23018_set_output_all -Wl,--wrap=mcp23018_read_pins
+endif
+
+# Vendor raw HID commands are answered ahead of Oryx, see vrmer_rawhid.h.
+EXTRALDFLAGS += -Wl,--wrap=raw_hid_receive
+
+# Scan-loop profiler, see vrmer_looptime.h. Off by default:
+# qmk compile ... -e VRMER_LOOPTIME_ENABLE=yes
+VRMER_LOOPTIME_ENABLE ?= no
+ifeq ($(strip $(VRMER_LOOPTIME_ENABLE)), yes)
+  SRC += vrmer_looptime.c
+  OPT_DEFS += -DVRMER_LOOPTIME_ENABLE
+  EXTRALDFLAGS += -Wl,--wrap=matrix_scan
+  EXTRALDFLAGS += -Wl,--wrap=process_combo -Wl,--wrap=combo_task
+  EXTRALDFLAGS += -Wl,--wrap=process_leader -Wl,--wrap=leader_task
+  EXTRALDFLAGS += -Wl,--wrap=process_key_override -Wl,--wrap=key_override_task
+  EXTRALDFLAGS += -Wl,--wrap=i2c_transmit -Wl,--wrap=i2c_receive
+  EXTRALDFLAGS += -Wl,--wrap=i2c_write_register -Wl,--wrap=i2c_read_register
+endif
@@ -0,0 +1,27 @@
+#include "vrmer_chord.h"
+
+static uint8_t gap_ms;
+
+void vrmer_chord_set_gap(uint8_t ms) {
+  gap_ms = ms;
+}
+
+void vrmer_chord_tap(uint16_t chord) {
+  uint8_t key = QK_MODS_GET_BASIC_KEYCODE(chord);
+  if (!IS_BASIC_KEYCODE(key)) {
+    tap_code16(chord);
+    return;
+  }
+  // Weak mods, as tap_code16() uses: they only last for this chord and leave
+  // held modifiers alone.
+  uint8_t mods = extract_mod_bits(chord);
+  add_weak_mods(mods);
+  add_key(key);
+  send_keyboard_report();
+  if (gap_ms) {
+    wait_ms(gap_ms);
+  }
+  del_key(key);
+  del_weak_mods(mods);
+  send_keyboard_report();
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include QMK_KEYBOARD_H
+
+// Single-report shortcut chords.
+//
+// tap_code16(LGUI(KC_C)) sends four reports: Cmd down, C down, C up, Cmd up.
+// Each one waits for its own host poll, so at USB_POLLING_INTERVAL_MS 10 a
+// shortcut takes about 40 ms to arrive. vrmer_chord_tap() puts the modifiers
+// and the key in one report and releases both in the next, halving that.
+//
+// A host that misses a press released in the very next report can be given a
+// gap between the two; the layout sets it per OS from the values below.
+
+#ifndef VRMER_CHORD_GAP_MAC
+#    define VRMER_CHORD_GAP_MAC 0
+#endif
+
+#ifndef VRMER_CHORD_GAP_WIN
+#    define VRMER_CHORD_GAP_WIN 0
+#endif
+
+// Tap chord, a basic keycode with optional modifiers such as LGUI(KC_C).
+// Anything else goes through tap_code16().
+void vrmer_chord_tap(uint16_t chord);
+
+// Milliseconds to wait between the press and the release report.
+void vrmer_chord_set_gap(uint8_t ms);
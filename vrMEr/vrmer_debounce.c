@@ -0,0 +1,129 @@
+#include "vrmer_debounce.h"
+
+#include "debounce.h"
+#include "vrmer_keymap.h"
+#include "vrmer_rawhid.h"
+
+_Static_assert(DEBOUNCE <= UINT8_MAX, "DEBOUNCE must fit the 8-bit countdown");
+
+// Counters per HID reply: 32 bytes less command, status and a 5-byte header.
+#define HID_COUNTERS (RAW_EPSIZE - 7)
+
+static matrix_row_t pending[MATRIX_ROWS]; // release seen, not reported yet
+static uint8_t      countdown[MATRIX_ROWS][MATRIX_COLS];
+static bool         any_pending;
+static uint16_t     last_scan;
+
+static uint8_t  bounces[MATRIX_ROWS][MATRIX_COLS];
+static uint16_t bounce_total;
+
+void debounce_init(uint8_t num_rows) {
+  memset(pending, 0, sizeof(pending));
+  any_pending = false;
+  last_scan   = timer_read();
+}
+
+static void count_bounce(uint8_t row, matrix_row_t keys) {
+  for (uint8_t col = 0; keys; col++, keys >>= 1) {
+    if (keys & 1) {
+      if (bounces[row][col] < UINT8_MAX) {
+        bounces[row][col]++;
+      }
+      if (bounce_total < UINT16_MAX) {
+        bounce_total++;
+      }
+    }
+  }
+}
+
+// Run the countdowns of a row's pending keys; returns the keys now released.
+// Keys in fresh only started their countdown this scan.
+static matrix_row_t count_down(uint8_t row, matrix_row_t fresh, uint8_t elapsed) {
+  matrix_row_t released = 0;
+  matrix_row_t keys     = pending[row];
+  for (uint8_t col = 0; keys; col++, keys >>= 1) {
+    if (!(keys & 1)) {
+      continue;
+    }
+    matrix_row_t bit  = (matrix_row_t)1 << col;
+    uint8_t      step = fresh & bit ? 0 : elapsed;
+    if (countdown[row][col] <= step) {
+      released |= bit;
+    } else {
+      countdown[row][col] -= step;
+    }
+  }
+  return released;
+}
+
+bool debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+  uint16_t now     = timer_read();
+  uint16_t elapsed = TIMER_DIFF_16(now, last_scan);
+  last_scan        = now;
+  if (!changed && !any_pending) {
+    return false;
+  }
+
+  bool cooked_changed = false;
+  any_pending         = false;
+  for (uint8_t row = 0; row < num_rows && row < MATRIX_ROWS; row++) {
+    matrix_row_t closed = raw[row];
+
+    // Closed again before the release was reported: that was a bounce.
+    matrix_row_t bounced = pending[row] & closed;
+    if (bounced) {
+      pending[row] &= ~bounced;
+      count_bounce(row, bounced);
+    }
+
+    matrix_row_t fresh = cooked[row] & ~closed & ~pending[row];
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+      if (fresh & ((matrix_row_t)1 << col)) {
+        countdown[row][col] = DEBOUNCE;
+      }
+    }
+    pending[row] |= fresh;
+
+    matrix_row_t released = pending[row] ? count_down(row, fresh, MIN(elapsed, UINT8_MAX)) : 0;
+    pending[row] &= ~released;
+
+    matrix_row_t pressed = closed & ~cooked[row];
+    if (pressed || released) {
+      cooked[row]    = (cooked[row] | pressed) & ~released;
+      cooked_changed = true;
+    }
+    if (pending[row]) {
+      any_pending = true;
+    }
+  }
+  return cooked_changed;
+}
+
+void vrmer_debounce_hid_read(uint8_t *data) {
+  uint8_t first = data[1];
+  memset(data + 1, 0, RAW_EPSIZE - 1);
+  if (first >= VOYAGER_SLOT_COUNT) {
+    data[1] = VRMER_HID_BAD_ARGUMENT;
+    return;
+  }
+  uint8_t count = MIN(HID_COUNTERS, VOYAGER_SLOT_COUNT - first);
+
+  uint8_t *p = data + 1;
+  *p++       = VRMER_HID_OK;
+  *p++       = DEBOUNCE;
+  *p++       = bounce_total & 0xff;
+  *p++       = bounce_total >> 8;
+  *p++       = first;
+  *p++       = count;
+  for (uint8_t i = 0; i < count; i++) {
+    uint8_t pos = VOYAGER_SLOT(first + i);
+    *p++        = bounces[pos >> 3][pos & 7];
+  }
+}
+
+void vrmer_debounce_hid_reset(uint8_t *data) {
+  memset(bounces, 0, sizeof(bounces));
+  bounce_total = 0;
+  memset(data + 1, 0, RAW_EPSIZE - 1);
+  data[1] = VRMER_HID_OK;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include QMK_KEYBOARD_H
+
+// Asymmetric per-key debounce: eager press, deferred release.
+//
+// QMK's default debounce (sym_defer_g) waits until the whole matrix has been
+// quiet for DEBOUNCE ms before reporting anything, so every press reaches the
+// host DEBOUNCE ms late, and USB polling comes on top. rules.mk selects
+// DEBOUNCE_TYPE = custom and this replaces it for the matrix of both halves.
+//
+// A press is reported on the first scan that sees it. A release is reported
+// only once the key has read as open for DEBOUNCE ms on its own; a key that
+// reads closed again before that was bouncing, and the release is dropped.
+// Contact bounce right after a press and right before a release both land in
+// that window, so neither turns into an extra key event.
+//
+// State is a bitmap of keys with a release pending, one bit per key in
+// matrix_row_t rows like the matrix itself, plus a countdown byte that is only
+// looked at for those keys. Between changes and with no release pending the
+// per-scan cost is one flag test.
+//
+// Every dropped release counts as a bounce against its key. The counters are
+// read and cleared over raw HID (see vrmer_rawhid.h and
+// `tools/rawhid/vrmer_hid.py debounce`). Most presses bounce a little, so the
+// counts grow with use and are not a fault by themselves; compare them with
+// the key's usage count. A key that bounces on far more of its presses than
+// its neighbours has a worn or dirty switch.
+
+#ifndef DEBOUNCE
+#    define DEBOUNCE 5
+#endif
+
+// Raw HID handlers. They rewrite the RAW_EPSIZE packet in data into the reply.
+void vrmer_debounce_hid_read(uint8_t *data);
+void vrmer_debounce_hid_reset(uint8_t *data);
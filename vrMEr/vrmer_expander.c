@@ -0,0 +1,164 @@
+#include "vrmer_expander.h"
+
+#include "mcp23018.h"
+#include "vrmer_looptime.h"
+
+#if VRMER_EXPANDER_BATCH
+#    include <hal.h>
+#    ifndef I2C_DRIVER
+#        define I2C_DRIVER I2CD1
+#    endif
+#endif
+
+#define MCP23018_GPIOA 0x12 // GPIOB follows it
+
+bool __real_matrix_scan_custom(matrix_row_t current_matrix[]);
+bool __real_mcp23018_set_output_all(uint8_t slave_addr, uint8_t confA, uint8_t confB);
+bool __real_mcp23018_read_pins(uint8_t slave_addr, mcp23018_port_t port, uint8_t *ret);
+
+static uint8_t addr;      // as matrix.c passes it
+static bool    idle;      // all columns latched selected, every key was up
+static uint8_t idle_a;    // port A and B as latched for idle
+static uint8_t idle_b;
+static uint8_t released;  // port B read in idle, every row high
+static bool    latched;   // latch_b holds port B's latch
+static uint8_t latch_b;
+static bool    pending;   // column select not sent yet
+static uint8_t pending_a;
+
+// What matrix.c asked for during the current scan.
+static bool    in_scan;
+static uint8_t selects;
+static uint8_t select_a; // AND of the column selects: every column selected
+static uint8_t select_b;
+static bool    any_down;
+static bool    failed;
+
+static void lost(void) {
+  idle    = false;
+  latched = false;
+  pending = false;
+  failed  = true;
+}
+
+static bool write_all(uint8_t a, uint8_t b) {
+  for (uint8_t i = 0; i <= VRMER_EXPANDER_RETRIES; i++) {
+    if (__real_mcp23018_set_output_all(addr, a, b)) {
+      latched = true;
+      latch_b = b;
+      return true;
+    }
+  }
+  lost();
+  return false;
+}
+
+static bool read_b(uint8_t *rx) {
+  for (uint8_t i = 0; i <= VRMER_EXPANDER_RETRIES; i++) {
+    if (__real_mcp23018_read_pins(addr, mcp23018_PORTB, rx)) {
+      return true;
+    }
+  }
+  lost();
+  return false;
+}
+
+// Select columns on port A and read port B in one transfer.
+static bool select_and_read(uint8_t a, uint8_t *rx) {
+#if VRMER_EXPANDER_BATCH
+  // A stopped driver (after a timeout) is started again by QMK's own calls.
+  if (I2C_DRIVER.state == I2C_READY) {
+    uint8_t  tx[2] = {MCP23018_GPIOA, a};
+    uint32_t start = vrmer_looptime_start();
+    msg_t    status = i2cMasterTransmitTimeout(&I2C_DRIVER, addr, tx, sizeof(tx), rx, 1, TIME_MS2I(VRMER_EXPANDER_TIMEOUT));
+    vrmer_looptime_stop(status == MSG_OK ? VRMER_LOOPTIME_I2C : VRMER_LOOPTIME_I2C_FAILED, start);
+    if (status == MSG_OK) {
+      return true;
+    }
+    if (status == MSG_TIMEOUT) {
+      // The bus is in an unknown state; the driver must be restarted.
+      i2cStop(&I2C_DRIVER);
+    }
+  }
+#endif
+  return write_all(a, latch_b) && read_b(rx);
+}
+
+bool __wrap_mcp23018_set_output_all(uint8_t slave_addr, uint8_t confA, uint8_t confB) {
+  addr = slave_addr;
+  if (!in_scan) {
+    idle = false;
+    return write_all(confA, confB);
+  }
+  selects++;
+  select_a &= confA;
+  select_b = confB;
+  if (idle) {
+    return true;
+  }
+  if (VRMER_EXPANDER_BATCH && latched && confB == latch_b) {
+    pending   = true;
+    pending_a = confA;
+    return true;
+  }
+  pending = false;
+  return write_all(confA, confB);
+}
+
+bool __wrap_mcp23018_read_pins(uint8_t slave_addr, mcp23018_port_t port, uint8_t *ret) {
+  if (!in_scan || port != mcp23018_PORTB) {
+    return __real_mcp23018_read_pins(slave_addr, port, ret);
+  }
+  addr = slave_addr;
+  if (idle) {
+    *ret = released;
+    return true;
+  }
+  bool ok;
+  if (pending) {
+    pending = false;
+    ok      = select_and_read(pending_a, ret);
+  } else {
+    ok = read_b(ret);
+  }
+  if (ok && (~*ret & VRMER_EXPANDER_ROWS)) {
+    any_down = true;
+  }
+  return ok;
+}
+
+bool __wrap_matrix_scan_custom(matrix_row_t current_matrix[]) {
+  if (idle) {
+    uint8_t rx;
+    if (!read_b(&rx)) {
+      // Let matrix.c's own transactions find the error.
+    } else if (~rx & VRMER_EXPANDER_ROWS) {
+      idle = false;
+    } else {
+      released = rx;
+    }
+  }
+
+  in_scan  = true;
+  selects  = 0;
+  select_a = 0xFF;
+  any_down = false;
+  failed   = false;
+  bool changed = __real_matrix_scan_custom(current_matrix);
+  in_scan      = false;
+
+  if (pending) {
+    pending = false;
+    write_all(pending_a, latch_b);
+  }
+  if (!selects || failed) {
+    return changed; // right half not scanned or not answering
+  }
+  if (idle ? select_a != idle_a || select_b != idle_b : !any_down) {
+    // Latch every column selected, or the LED bits changed while idle.
+    idle   = write_all(select_a, select_b);
+    idle_a = select_a;
+    idle_b = select_b;
+  }
+  return changed;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include QMK_KEYBOARD_H
+
+// Change-driven scan of the right half.
+//
+// keyboards/zsa/voyager/matrix.c reads the right half through the MCP23018
+// I/O expander: for each of its 7 columns it selects the column on port A
+// with mcp23018_set_output_all and reads the 6 rows on port B with
+// mcp23018_read_pins. That is 14 I2C transactions on every scan, with no key
+// down on that side most of the time.
+//
+// This sits between matrix.c and the expander driver through -Wl,--wrap (see
+// rules.mk); matrix.c itself comes with the QMK checkout and is unchanged.
+// It is built only with VRMER_EXPANDER_SCAN = yes, and
+// tools/sim/test/vrmer_expander_test.c runs it against a model of the
+// expander.
+//
+// - Idle: once a full scan finds every right-hand key up, all columns are
+//   selected at once and left latched. A scan then starts with one read of
+//   port B: if every row reads high, nothing changed and matrix.c's selects
+//   and reads are answered from that read without touching the bus. Any row
+//   reading low falls through to a full scan in the same pass, so a press is
+//   not reported later than before. The expander's own change detection
+//   (GPINTEN, read through INTF/INTCAP) would not save anything: the cable to
+//   the right half carries only the I2C lines, not INT, so INTF would be
+//   polled at the same one transaction, and INTCAP holds the port as it was
+//   at the first change where this read gives the rows as they are now.
+// - Full scan: the column select and the row read of a column go out as one
+//   write-then-read transfer (GPIOA, then GPIOB by the expander's address
+//   auto-increment) through the ChibiOS driver's DMA, halving the
+//   transactions while a key is held. Port B is written only when matrix.c
+//   changes its LED bit.
+// - Bus errors: a failed transaction is retried VRMER_EXPANDER_RETRIES
+//   times through QMK's driver, which restarts the peripheral after a
+//   timeout. If it still fails the error goes to matrix.c as before, so the
+//   disconnect and reconnect handling of the detachable right half stays
+//   upstream's; this module drops back to full scans until the expander
+//   answers again.
+//
+// The matrix and i2c sections of the loop profiler (vrmer_looptime.h) show
+// the effect.
+
+// Port B bits that are rows; they read low while a key in the selected
+// column is down.
+#ifndef VRMER_EXPANDER_ROWS
+#    define VRMER_EXPANDER_ROWS 0x3F
+#endif
+
+#ifndef VRMER_EXPANDER_RETRIES
+#    define VRMER_EXPANDER_RETRIES 1
+#endif
+
+// Per transaction, as in QMK's mcp23018 driver.
+#ifndef VRMER_EXPANDER_TIMEOUT
+#    define VRMER_EXPANDER_TIMEOUT 100
+#endif
+
+// Combined select-and-read transfers. They need ChibiOS's I2C driver.
+#ifndef VRMER_EXPANDER_BATCH
+#    ifdef PROTOCOL_CHIBIOS
+#        define VRMER_EXPANDER_BATCH 1
+#    else
+#        define VRMER_EXPANDER_BATCH 0
+#    endif
+#endif
@@ -0,0 +1,96 @@
+#include "vrmer_fastpath.h"
+
+#include "vrmer_latency.h"
+#include "vrmer_usage.h"
+
+typedef struct {
+  keypos_t key;
+  uint8_t  code;
+} fast_key_t;
+
+// Keys that went down on the fast path, released the same way.
+static fast_key_t fast_keys[VRMER_FASTPATH_KEYS];
+static uint8_t    fast_count;
+
+// Positions held down through the full pipeline.
+static matrix_row_t slow_held[MATRIX_ROWS];
+static uint8_t      slow_count;
+
+static bool listed(uint16_t keycode) {
+  return keycode < 256 && (pgm_read_byte(&vrmer_fastpath_keycodes[keycode >> 3]) >> (keycode & 7)) & 1;
+}
+
+// Nothing under way that the full pipeline would apply to the next key.
+static bool idle(void) {
+  if (slow_count || fast_count == VRMER_FASTPATH_KEYS || get_oneshot_mods() || is_oneshot_layer_active()) {
+    return false;
+  }
+#ifdef CAPS_WORD_ENABLE
+  if (is_caps_word_on()) {
+    return false;
+  }
+#endif
+#ifdef LEADER_ENABLE
+  if (leader_sequence_active()) {
+    return false;
+  }
+#endif
+#ifdef ORYX_ENABLE
+  if (rawhid_state.paired) {
+    return false;
+  }
+#endif
+  return true;
+}
+
+static void send(uint8_t code, keyrecord_t *record) {
+  vrmer_latency_record(code, record);
+  vrmer_usage_record(code, record);
+#ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
+  process_rgb_matrix(record->event.key.row, record->event.key.col, record->event.pressed);
+#endif
+  if (record->event.pressed) {
+#ifdef REPEAT_KEY_ENABLE
+    set_last_keycode(code);
+    set_last_mods(get_mods() | get_weak_mods());
+#endif
+    register_code(code);
+  } else {
+    unregister_code(code);
+  }
+}
+
+bool vrmer_fastpath_process(uint16_t keycode, keyrecord_t *record) {
+  keypos_t key = record->event.key;
+  if (record->event.type != KEY_EVENT || key.row >= MATRIX_ROWS || key.col >= MATRIX_COLS) {
+    return true;
+  }
+  matrix_row_t bit = (matrix_row_t)1 << key.col;
+
+  if (record->event.pressed) {
+    if (listed(keycode) && idle()) {
+      fast_keys[fast_count++] = (fast_key_t){key, keycode};
+      send(keycode, record);
+      return false;
+    }
+    if (!(slow_held[key.row] & bit)) {
+      slow_held[key.row] |= bit;
+      slow_count++;
+    }
+    return true;
+  }
+
+  for (uint8_t i = 0; i < fast_count; i++) {
+    if (fast_keys[i].key.row == key.row && fast_keys[i].key.col == key.col) {
+      uint8_t code = fast_keys[i].code;
+      fast_keys[i] = fast_keys[--fast_count];
+      send(code, record);
+      return false;
+    }
+  }
+  if (slow_held[key.row] & bit) {
+    slow_held[key.row] &= ~bit;
+    slow_count--;
+  }
+  return true;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include QMK_KEYBOARD_H
+
+// Fast path for plain keys.
+//
+// A press normally goes through combos, the tap-hold state machine, caps
+// word, leader, key overrides, repeat key and process_record_user before its
+// key reaches the report. For a plain letter typed on its own none of them
+// do anything. tools/fastpath/gen_fastpath.py lists the keycodes of the
+// keymap that none of them ever act on (fastpath.inc); a press of one of
+// those is registered here, from pre_process_record_user, and its release
+// unregisters it the same way.
+//
+// The bitmap says what a key is, not what the keyboard is doing, so a listed
+// key still takes the full pipeline while any of this is going on:
+//  - a key that went down through the full pipeline is still held (a
+//    tap-hold key being decided, a layer key, a combo key, ...);
+//  - a one-shot layer or one-shot mods are waiting, caps word is on, or a
+//    leader sequence is being typed;
+//  - Keymapp is connected and wants to see every key (Oryx live training).
+// Then the result is the same as with the full pipeline, only sooner. The
+// latency and usage counters and the repeat key see fast keys as before.
+//
+// At most VRMER_FASTPATH_KEYS fast keys are held at once; beyond that keys
+// take the full pipeline.
+
+#ifndef VRMER_FASTPATH_KEYS
+#    define VRMER_FASTPATH_KEYS 8
+#endif
+
+// Generated bitmap, bit (kc & 7) of byte kc >> 3, defined by the layout.
+extern const uint8_t vrmer_fastpath_keycodes[32];
+
+// Handle a matrix event. Returns false if the key was sent here; call from
+// pre_process_record_user and return false then.
+bool vrmer_fastpath_process(uint16_t keycode, keyrecord_t *record);
@@ -0,0 +1,94 @@
+#include "vrmer_keymap.h"
+
+typedef struct {
+  uint16_t keycode;
+  uint8_t  layer; // highest active layer that is not transparent here
+} resolved_key_t;
+
+static resolved_key_t resolved[MATRIX_ROWS][MATRIX_COLS];
+static matrix_row_t   resolved_valid[MATRIX_ROWS];
+static layer_state_t  resolved_state;
+
+// These replace weak QMK lookups. They cannot sit in keymap.c: QMK compiles
+// the keymap inside keymap_introspection.c, next to the weak introspection
+// versions.
+
+uint8_t keymap_layer_count(void) {
+  return vrmer_layer_count;
+}
+
+uint16_t keycode_at_keymap_location(uint8_t layer, uint8_t row, uint8_t column) {
+  if (layer >= vrmer_layer_count || row >= MATRIX_ROWS || column >= MATRIX_COLS) {
+    return KC_TRANSPARENT;
+  }
+  const vrmer_layer_t   *entry   = &vrmer_layers[layer];
+  const vrmer_overlay_t *overlay = pgm_read_ptr(&entry->overlay);
+  uint8_t                count   = pgm_read_byte(&entry->count);
+  uint8_t                pos     = row << 3 | column;
+  for (uint8_t i = 0; i < count; i++) {
+    if (pgm_read_byte(&overlay[i].pos) == pos) {
+      return pgm_read_word(&overlay[i].keycode);
+    }
+  }
+  return pgm_read_word(&keymaps[pgm_read_byte(&entry->keymap)][row][column]);
+}
+
+static void resolve(keypos_t key, layer_state_t layers) {
+  resolved_key_t *entry = &resolved[key.row][key.col];
+  for (int8_t i = MAX_LAYER - 1; i >= 0; i--) {
+    if (layers & ((layer_state_t)1 << i)) {
+      uint16_t keycode = keycode_at_keymap_location(i, key.row, key.col);
+      if (keycode != KC_TRANSPARENT) {
+        entry->layer   = i;
+        entry->keycode = keycode;
+        return;
+      }
+    }
+  }
+  entry->layer   = get_highest_layer(default_layer_state);
+  entry->keycode = keycode_at_keymap_location(entry->layer, key.row, key.col);
+}
+
+uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t key) {
+  if (key.row >= MATRIX_ROWS || key.col >= MATRIX_COLS) {
+    return KC_NO;
+  }
+  layer_state_t layers = layer_state | default_layer_state;
+  if (layers != resolved_state) {
+    memset(resolved_valid, 0, sizeof(resolved_valid));
+    resolved_state = layers;
+  }
+  matrix_row_t bit = (matrix_row_t)1 << key.col;
+  if (!(resolved_valid[key.row] & bit)) {
+    resolve(key, layers);
+    resolved_valid[key.row] |= bit;
+  }
+
+  const resolved_key_t *entry = &resolved[key.row][key.col];
+  if (layer == entry->layer) {
+    return entry->keycode;
+  }
+  // Active layers above the resolved one are transparent at this position.
+  if (layer > entry->layer && (layers & ((layer_state_t)1 << layer))) {
+    return KC_TRANSPARENT;
+  }
+  // Anything else, such as the layer a held key was pressed on.
+  return keycode_at_keymap_location(layer, key.row, key.col);
+}
+
+uint8_t vrmer_keymap_slot(keypos_t key) {
+  // The inverse of VOYAGER_SLOT().
+  if (key.row < 4 && key.col >= 1) {
+    return key.row * 6 + key.col - 1;
+  }
+  if (key.row == 5 && key.col < 2) {
+    return 24 + key.col;
+  }
+  if (key.row >= 6 && key.row < 10 && key.col < 6) {
+    return 26 + (key.row - 6) * 6 + key.col;
+  }
+  if (key.row == 11 && key.col >= 5) {
+    return 50 + key.col - 5;
+  }
+  return VOYAGER_NO_SLOT;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include QMK_KEYBOARD_H
+
+// Shared layers with per-OS overlays.
+//
+// The macOS and Windows variants of a layer differ in a handful of keys, so
+// keymaps[] stores each pair once with the macOS keycodes, and the Windows
+// layer lists only the keys it changes. Layer numbers are unchanged: the
+// keymap lookups below map each layer to its stored layer and overlay, so
+// Oryx, the ledmap and default_layer_set() see the same nine layers as before.
+//
+// keymap_key_to_keycode() is replaced as well, to cache what each matrix
+// position resolves to under the current layer_state | default_layer_state.
+// QMK's layer walk asks it for every active layer from the top down; with
+// the cache each of those answers is a RAM read. Any change to either layer
+// state empties the cache, and a position is resolved again on its next
+// lookup.
+
+// Matrix position of LAYOUT_voyager slot kNN, packed as row << 3 | column.
+#define VOYAGER_SLOT(n) \
+  ((n) < 24 ? ((n) / 6) << 3 | ((n) % 6 + 1) : \
+   (n) < 26 ? 5 << 3 | ((n) - 24) : \
+   (n) < 50 ? (6 + ((n) - 26) / 6) << 3 | ((n) - 26) % 6 : \
+              11 << 3 | ((n) - 45))
+
+#define VOYAGER_SLOT_COUNT 52
+#define VOYAGER_NO_SLOT    0xFF
+
+typedef struct {
+  uint8_t  pos; // VOYAGER_SLOT()
+  uint16_t keycode;
+} vrmer_overlay_t;
+
+typedef struct {
+  uint8_t                keymap;  // index into keymaps[]
+  uint8_t                count;   // entries in overlay
+  const vrmer_overlay_t *overlay; // keys that differ from the stored layer
+} vrmer_layer_t;
+
+// Provided by the layout, one entry per layer.
+extern const uint16_t      keymaps[][MATRIX_ROWS][MATRIX_COLS];
+extern const vrmer_layer_t vrmer_layers[];
+extern const uint8_t       vrmer_layer_count;
+
+// LAYOUT_voyager slot (0 for k00 .. 51 for k51) of a matrix position, or
+// VOYAGER_NO_SLOT where the matrix has no key.
+uint8_t vrmer_keymap_slot(keypos_t key);
@@ -0,0 +1,145 @@
+#include "vrmer_latency.h"
+
+#include <string.h>
+
+#include "vrmer_rawhid.h"
+
+typedef struct {
+  uint16_t bucket[VRMER_LATENCY_BUCKETS];
+  uint16_t max;
+  uint32_t total; // ms
+} latency_hist_t;
+
+static latency_hist_t hist[VRMER_LATENCY_CLASSES];
+
+static bool     pending;
+static uint8_t  pending_class;
+static uint16_t pending_time;
+
+// Copy of the host driver with the report senders routed through here.
+static host_driver_t  latency_driver;
+static host_driver_t *real_driver;
+
+static uint8_t bucket_of(uint16_t ms) {
+  uint8_t b = 0;
+  while (ms && b < VRMER_LATENCY_BUCKETS - 1) {
+    ms >>= 1;
+    b++;
+  }
+  return b;
+}
+
+static void close_sample(void) {
+  if (!pending) {
+    return;
+  }
+  pending = false;
+
+  uint16_t        ms = timer_elapsed(pending_time);
+  latency_hist_t *h  = &hist[pending_class];
+  uint16_t       *n  = &h->bucket[bucket_of(ms)];
+  if (*n < UINT16_MAX) {
+    (*n)++;
+  }
+  if (ms > h->max) {
+    h->max = ms;
+  }
+  if (h->total <= UINT32_MAX - ms) {
+    h->total += ms;
+  }
+}
+
+static void latency_send_keyboard(report_keyboard_t *report) {
+  close_sample();
+  real_driver->send_keyboard(report);
+}
+
+static void latency_send_nkro(report_nkro_t *report) {
+  close_sample();
+  real_driver->send_nkro(report);
+}
+
+static void latency_send_mouse(report_mouse_t *report) {
+  close_sample();
+  real_driver->send_mouse(report);
+}
+
+static void latency_send_extra(report_extra_t *report) {
+  close_sample();
+  real_driver->send_extra(report);
+}
+
+void vrmer_latency_record(uint16_t keycode, keyrecord_t *record) {
+  if (!record->event.pressed) {
+    return;
+  }
+  // A key reaching process_record later than its matrix scan sat in the
+  // tap-hold or combo buffer. Tap-hold keys count as deferred even when they
+  // resolve within the same millisecond.
+  bool deferred = IS_QK_MOD_TAP(keycode) || IS_QK_LAYER_TAP(keycode) || timer_elapsed(record->event.time) > 0;
+
+  pending       = true;
+  pending_class = deferred ? VRMER_LATENCY_DEFERRED : VRMER_LATENCY_IMMEDIATE;
+  pending_time  = record->event.time;
+}
+
+void vrmer_latency_task(void) {
+  // Reports go out synchronously while a key is processed, so a press still
+  // pending here (layer keys, RGB keys, ...) never produced one.
+  pending = false;
+
+  // The protocol layer installs its driver after keyboard_post_init_user, so
+  // wrap whatever is current instead of hooking once at boot.
+  host_driver_t *driver = host_get_driver();
+  if (!driver || driver == &latency_driver) {
+    return;
+  }
+  real_driver    = driver;
+  latency_driver = *driver;
+  if (driver->send_keyboard) {
+    latency_driver.send_keyboard = latency_send_keyboard;
+  }
+  if (driver->send_nkro) {
+    latency_driver.send_nkro = latency_send_nkro;
+  }
+  if (driver->send_mouse) {
+    latency_driver.send_mouse = latency_send_mouse;
+  }
+  if (driver->send_extra) {
+    latency_driver.send_extra = latency_send_extra;
+  }
+  host_set_driver(&latency_driver);
+}
+
+static uint8_t *put16(uint8_t *p, uint16_t v) {
+  *p++ = v & 0xff;
+  *p++ = v >> 8;
+  return p;
+}
+
+void vrmer_latency_hid_read(uint8_t *data) {
+  uint8_t class = data[1];
+  memset(data + 1, 0, RAW_EPSIZE - 1);
+  if (class >= VRMER_LATENCY_CLASSES) {
+    data[1] = VRMER_HID_BAD_ARGUMENT;
+    return;
+  }
+  const latency_hist_t *h = &hist[class];
+
+  uint8_t *p = data + 1;
+  *p++       = VRMER_HID_OK;
+  *p++       = class;
+  *p++       = VRMER_LATENCY_BUCKETS;
+  for (uint8_t i = 0; i < VRMER_LATENCY_BUCKETS; i++) {
+    p = put16(p, h->bucket[i]);
+  }
+  p = put16(p, h->max);
+  p = put16(p, h->total & 0xffff);
+  put16(p, h->total >> 16);
+}
+
+void vrmer_latency_hid_reset(uint8_t *data) {
+  memset(hist, 0, sizeof(hist));
+  memset(data + 1, 0, RAW_EPSIZE - 1);
+  data[1] = VRMER_HID_OK;
+}
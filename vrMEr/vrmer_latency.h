@@ -0,0 +1,40 @@
+#pragma once
+
+#include QMK_KEYBOARD_H
+
+#include "host.h"
+
+// Keypress latency histogram.
+//
+// Each key press is stamped with its matrix time (record->event.time). The
+// first HID report queued while that press is being processed closes the
+// sample: the time from matrix detection to the report reaching the host
+// driver goes into a histogram. Presses that go through tap-hold or combo
+// buffering are kept apart from keys that were sent straight away, so the cost
+// of deferral shows up on its own. Host polling comes on top and is not
+// visible to the firmware.
+//
+// The histogram lives in RAM and is read and cleared over raw HID (see
+// vrmer_rawhid.h and tools/rawhid/vrmer_hid.py).
+
+// Bucket i holds samples of [2^(i-1), 2^i) ms; bucket 0 holds 0 ms and the
+// last bucket everything from 512 ms up.
+#define VRMER_LATENCY_BUCKETS 11
+
+enum vrmer_latency_class {
+  VRMER_LATENCY_IMMEDIATE,
+  VRMER_LATENCY_DEFERRED,
+  VRMER_LATENCY_CLASSES,
+};
+
+// Open a sample for a key press. Call first thing in process_record_user, so
+// reports sent by the user code itself are attributed to the key.
+void vrmer_latency_record(uint16_t keycode, keyrecord_t *record);
+
+// Keep the report hook installed on the current host driver and drop presses
+// that produced no report. Call from housekeeping_task_user.
+void vrmer_latency_task(void);
+
+// Raw HID handlers. They rewrite the RAW_EPSIZE packet in data into the reply.
+void vrmer_latency_hid_read(uint8_t *data);
+void vrmer_latency_hid_reset(uint8_t *data);
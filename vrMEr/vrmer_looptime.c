@@ -0,0 +1,203 @@
+#include "vrmer_looptime.h"
+
+#include <string.h>
+
+#include "i2c_master.h"
+#include "vrmer_rawhid.h"
+
+// The realtime counter is the DWT cycle counter on the Voyager's Cortex-M4.
+// Elsewhere the millisecond timer stands in, which only shows slow sections.
+#if defined(PROTOCOL_CHIBIOS)
+#    define NOW()        ((uint32_t)chSysGetRealtimeCounterX())
+#    define TICKS_PER_US (STM32_SYSCLK / 1000000)
+#else
+#    define NOW()        (timer_read32() * 1000)
+#    define TICKS_PER_US 1
+#endif
+
+typedef struct {
+  uint32_t calls;
+  uint32_t max; // ticks
+  uint64_t total;
+} section_stats_t;
+
+static section_stats_t stats[VRMER_LOOPTIME_SECTIONS];
+
+static uint32_t since;       // timer_read32 at the last reset
+static uint32_t loop_start;  // ticks at the previous housekeeping call
+static bool     loop_open;
+static uint32_t window_start;
+static uint16_t window_passes;
+static uint16_t passes_per_second;
+
+uint32_t vrmer_looptime_start(void) {
+  return NOW();
+}
+
+void vrmer_looptime_stop(uint8_t section, uint32_t start) {
+  uint32_t         ticks = NOW() - start;
+  section_stats_t *s     = &stats[section];
+  s->calls++;
+  s->total += ticks;
+  if (ticks > s->max) {
+    s->max = ticks;
+  }
+}
+
+void vrmer_looptime_task(void) {
+  if (loop_open) {
+    vrmer_looptime_stop(VRMER_LOOPTIME_LOOP, loop_start);
+  }
+  loop_start = NOW();
+  loop_open  = true;
+
+  if (window_passes < UINT16_MAX) {
+    window_passes++;
+  }
+  if (timer_elapsed32(window_start) >= 1000) {
+    passes_per_second = window_passes;
+    window_passes     = 0;
+    window_start      = timer_read32();
+  }
+}
+
+// QMK entry points, routed here by -Wl,--wrap in rules.mk.
+
+uint8_t __real_matrix_scan(void);
+
+uint8_t __wrap_matrix_scan(void) {
+  uint32_t start   = NOW();
+  uint8_t  changed = __real_matrix_scan();
+  vrmer_looptime_stop(VRMER_LOOPTIME_MATRIX, start);
+  return changed;
+}
+
+#ifdef COMBO_ENABLE
+bool __real_process_combo(uint16_t keycode, keyrecord_t *record);
+void __real_combo_task(void);
+
+bool __wrap_process_combo(uint16_t keycode, keyrecord_t *record) {
+  uint32_t start = NOW();
+  bool     cont  = __real_process_combo(keycode, record);
+  vrmer_looptime_stop(VRMER_LOOPTIME_COMBO, start);
+  return cont;
+}
+
+void __wrap_combo_task(void) {
+  uint32_t start = NOW();
+  __real_combo_task();
+  vrmer_looptime_stop(VRMER_LOOPTIME_COMBO, start);
+}
+#endif
+
+#ifdef LEADER_ENABLE
+bool __real_process_leader(uint16_t keycode, keyrecord_t *record);
+void __real_leader_task(void);
+
+bool __wrap_process_leader(uint16_t keycode, keyrecord_t *record) {
+  uint32_t start = NOW();
+  bool     cont  = __real_process_leader(keycode, record);
+  vrmer_looptime_stop(VRMER_LOOPTIME_LEADER, start);
+  return cont;
+}
+
+void __wrap_leader_task(void) {
+  uint32_t start = NOW();
+  __real_leader_task();
+  vrmer_looptime_stop(VRMER_LOOPTIME_LEADER, start);
+}
+#endif
+
+#ifdef KEY_OVERRIDE_ENABLE
+bool __real_process_key_override(const uint16_t keycode, const keyrecord_t *const record);
+void __real_key_override_task(void);
+
+bool __wrap_process_key_override(const uint16_t keycode, const keyrecord_t *const record) {
+  uint32_t start = NOW();
+  bool     cont  = __real_process_key_override(keycode, record);
+  vrmer_looptime_stop(VRMER_LOOPTIME_KEY_OVERRIDE, start);
+  return cont;
+}
+
+void __wrap_key_override_task(void) {
+  uint32_t start = NOW();
+  __real_key_override_task();
+  vrmer_looptime_stop(VRMER_LOOPTIME_KEY_OVERRIDE, start);
+}
+#endif
+
+// I2C transactions of the expander and LED drivers.
+
+static i2c_status_t i2c_done(i2c_status_t status, uint32_t start) {
+  vrmer_looptime_stop(status == I2C_STATUS_SUCCESS ? VRMER_LOOPTIME_I2C : VRMER_LOOPTIME_I2C_FAILED, start);
+  return status;
+}
+
+i2c_status_t __real_i2c_transmit(uint8_t address, const uint8_t *data, uint16_t length, uint16_t timeout);
+i2c_status_t __real_i2c_receive(uint8_t address, uint8_t *data, uint16_t length, uint16_t timeout);
+i2c_status_t __real_i2c_write_register(uint8_t devaddr, uint8_t regaddr, const uint8_t *data, uint16_t length, uint16_t timeout);
+i2c_status_t __real_i2c_read_register(uint8_t devaddr, uint8_t regaddr, uint8_t *data, uint16_t length, uint16_t timeout);
+
+i2c_status_t __wrap_i2c_transmit(uint8_t address, const uint8_t *data, uint16_t length, uint16_t timeout) {
+  uint32_t start = NOW();
+  return i2c_done(__real_i2c_transmit(address, data, length, timeout), start);
+}
+
+i2c_status_t __wrap_i2c_receive(uint8_t address, uint8_t *data, uint16_t length, uint16_t timeout) {
+  uint32_t start = NOW();
+  return i2c_done(__real_i2c_receive(address, data, length, timeout), start);
+}
+
+i2c_status_t __wrap_i2c_write_register(uint8_t devaddr, uint8_t regaddr, const uint8_t *data, uint16_t length, uint16_t timeout) {
+  uint32_t start = NOW();
+  return i2c_done(__real_i2c_write_register(devaddr, regaddr, data, length, timeout), start);
+}
+
+i2c_status_t __wrap_i2c_read_register(uint8_t devaddr, uint8_t regaddr, uint8_t *data, uint16_t length, uint16_t timeout) {
+  uint32_t start = NOW();
+  return i2c_done(__real_i2c_read_register(devaddr, regaddr, data, length, timeout), start);
+}
+
+static uint8_t *put16(uint8_t *p, uint16_t v) {
+  *p++ = v & 0xff;
+  *p++ = v >> 8;
+  return p;
+}
+
+static uint8_t *put32(uint8_t *p, uint32_t v) {
+  p = put16(p, v & 0xffff);
+  return put16(p, v >> 16);
+}
+
+void vrmer_looptime_hid_read(uint8_t *data) {
+  uint8_t section = data[1];
+  memset(data + 1, 0, RAW_EPSIZE - 1);
+  if (section >= VRMER_LOOPTIME_SECTIONS) {
+    data[1] = VRMER_HID_BAD_ARGUMENT;
+    return;
+  }
+  const section_stats_t *s = &stats[section];
+
+  // Time spent in the section since the reset, in 1/100 %.
+  uint64_t elapsed_us = (uint64_t)timer_elapsed32(since) * 1000;
+  uint64_t total_us   = s->total / TICKS_PER_US;
+  uint32_t share      = elapsed_us ? MIN(total_us * 10000 / elapsed_us, 10000) : 0;
+
+  uint8_t *p = data + 1;
+  *p++       = VRMER_HID_OK;
+  *p++       = VRMER_LOOPTIME_SECTIONS;
+  *p++       = section;
+  p          = put16(p, passes_per_second);
+  p          = put32(p, s->calls);
+  p          = put32(p, s->calls ? s->total * 1000 / TICKS_PER_US / s->calls : 0);
+  p          = put32(p, (uint64_t)s->max * 1000 / TICKS_PER_US);
+  put16(p, share);
+}
+
+void vrmer_looptime_hid_reset(uint8_t *data) {
+  memset(stats, 0, sizeof(stats));
+  loop_open = false;
+  since     = timer_read32();
+  memset(data + 1, 0, RAW_EPSIZE - 1);
+  data[1] = VRMER_HID_OK;
+}
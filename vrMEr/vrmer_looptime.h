@@ -0,0 +1,67 @@
+#pragma once
+
+#include QMK_KEYBOARD_H
+
+// Scan-loop profiler.
+//
+// Built only with VRMER_LOOPTIME_ENABLE = yes in rules.mk. It times how long
+// each pass of the main loop spends in the subsystems below and counts
+// passes per second, so the cost of the enabled features can be told apart
+// before deciding what to optimize or turn off.
+//
+// QMK's own entry points (matrix_scan, process_combo/combo_task,
+// process_leader/leader_task, process_key_override/key_override_task) are
+// timed through -Wl,--wrap, set up in rules.mk; the layout's own code calls
+// vrmer_looptime_start/stop around the RGB indicators and the hand-off to
+// Oryx's raw HID handler. A section that runs inside another one (a combo
+// firing its keys through key overrides, say) counts towards both.
+//
+// I2C transactions are timed the same way, so the part of the matrix scan
+// spent reading the right half's I/O expander (and of the RGB flush spent on
+// the LED drivers) shows up on its own; failed transactions, timeouts
+// included, are also counted apart. vrmer_expander.h cuts down how many
+// transactions the right half takes per scan.
+//
+// Times come from the cycle counter and are kept since the last reset. They
+// are read and cleared over raw HID (see vrmer_rawhid.h and
+// `tools/rawhid/vrmer_hid.py looptime`). Without the option the calls below
+// compile to nothing.
+
+enum vrmer_looptime_section {
+  VRMER_LOOPTIME_LOOP, // one whole pass, housekeeping to housekeeping
+  VRMER_LOOPTIME_MATRIX,
+  VRMER_LOOPTIME_COMBO,
+  VRMER_LOOPTIME_LEADER,
+  VRMER_LOOPTIME_KEY_OVERRIDE,
+  VRMER_LOOPTIME_RGB_INDICATORS,
+  VRMER_LOOPTIME_ORYX,
+  VRMER_LOOPTIME_I2C,
+  VRMER_LOOPTIME_I2C_FAILED, // transactions that did not succeed
+  VRMER_LOOPTIME_SECTIONS,
+};
+
+#ifdef VRMER_LOOPTIME_ENABLE
+
+// Cycle counter value to hand to vrmer_looptime_stop.
+uint32_t vrmer_looptime_start(void);
+
+// Add the time since start to a section.
+void vrmer_looptime_stop(uint8_t section, uint32_t start);
+
+// Close one loop pass and update the pass rate. Call from
+// housekeeping_task_user.
+void vrmer_looptime_task(void);
+
+// Raw HID handlers. They rewrite the RAW_EPSIZE packet in data into the reply.
+void vrmer_looptime_hid_read(uint8_t *data);
+void vrmer_looptime_hid_reset(uint8_t *data);
+
+#else
+
+static inline uint32_t vrmer_looptime_start(void) {
+  return 0;
+}
+static inline void vrmer_looptime_stop(uint8_t section, uint32_t start) {}
+static inline void vrmer_looptime_task(void) {}
+
+#endif
@@ -0,0 +1,237 @@
+#include "vrmer_mouse.h"
+
+#include <stdlib.h>
+
+#if defined(POINTING_DEVICE_HIRES_SCROLL_ENABLE) && defined(POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER)
+#    define WHEEL_UNITS POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER
+#else
+#    define WHEEL_UNITS 1
+#endif
+
+// Positions and speeds are in 1/65536 unit; speeds per millisecond.
+#define ONE 65536
+
+// Ticks made up after a stall before the model skips ahead.
+#define MAX_CATCH_UP 16
+
+// Reports carry at most this many units per axis; the rest waits.
+#define REPORT_MAX 127
+
+typedef struct {
+  uint16_t start; // units per second
+  uint16_t max;
+  uint16_t time_to_max; // ms
+  uint8_t  friction;    // 1/256 of the speed lost per ms when gliding
+} axis_config_t;
+
+static const axis_config_t pointer = {
+  VRMER_MOUSE_START_SPEED, VRMER_MOUSE_MAX_SPEED, VRMER_MOUSE_TIME_TO_MAX, VRMER_MOUSE_FRICTION,
+};
+static const axis_config_t wheel = {
+  VRMER_MOUSE_WHEEL_START_SPEED * WHEEL_UNITS, VRMER_MOUSE_WHEEL_MAX_SPEED * WHEEL_UNITS,
+  VRMER_MOUSE_WHEEL_TIME_TO_MAX, VRMER_MOUSE_WHEEL_FRICTION,
+};
+
+enum { AXIS_X, AXIS_Y, AXIS_V, AXIS_H, AXES };
+
+typedef struct {
+  int8_t   dir;   // -1, 0 or 1 from the held keys
+  uint16_t since; // when dir last became non-zero
+  int32_t  speed;
+  int32_t  pos; // movement not reported yet
+} axis_t;
+
+static axis_t axes[AXES];
+
+// Held keys, one bit per direction: negative then positive for each axis.
+static uint8_t  held;
+static uint8_t  accel;
+static bool     active;
+static uint16_t last_tick;
+static uint16_t last_report;
+
+static const axis_config_t *config_of(uint8_t axis) {
+  return axis < AXIS_V ? &pointer : &wheel;
+}
+
+static int32_t per_ms(uint32_t units_per_second) {
+  return units_per_second * ONE / 1000;
+}
+
+static uint16_t held_speed(const axis_config_t *c, uint16_t held_ms) {
+  if (accel & (1 << 0)) {
+    return c->start / 4;
+  }
+  if (accel & (1 << 1)) {
+    return c->start / 2;
+  }
+  if ((accel & (1 << 2)) || held_ms >= c->time_to_max) {
+    return c->max;
+  }
+  uint32_t f = (uint32_t)held_ms * 256 / c->time_to_max;
+#if VRMER_MOUSE_CURVE == 2
+  f = f * f / 256;
+#elif VRMER_MOUSE_CURVE == 3
+  f = f * f / 256 * f / 256;
+#endif
+  return c->start + (uint32_t)(c->max - c->start) * f / 256;
+}
+
+static void step(void) {
+  for (uint8_t i = 0; i < AXES; i++) {
+    axis_t              *a = &axes[i];
+    const axis_config_t *c = config_of(i);
+    if (a->dir) {
+      uint16_t held_ms = TIMER_DIFF_16(last_tick, a->since);
+      if (held_ms > c->time_to_max) {
+        // Keep the 16-bit difference from wrapping on long holds.
+        a->since = last_tick - c->time_to_max;
+      }
+      a->speed = a->dir * per_ms(held_speed(c, held_ms));
+    } else if (a->speed) {
+      a->speed = a->speed * (256 - c->friction) / 256;
+      if ((accel & 0x03) || abs(a->speed) < per_ms(c->start)) {
+        a->speed = 0;
+      }
+    }
+    a->pos += a->speed * VRMER_MOUSE_TICK_MS;
+  }
+}
+
+static int8_t take(axis_t *a) {
+  int32_t n = a->pos / ONE;
+  if (n > REPORT_MAX) {
+    n = REPORT_MAX;
+  } else if (n < -REPORT_MAX) {
+    n = -REPORT_MAX;
+  }
+  a->pos -= n * ONE;
+  return n;
+}
+
+static void send(void) {
+  int8_t x = take(&axes[AXIS_X]);
+  int8_t y = take(&axes[AXIS_Y]);
+  int8_t v = take(&axes[AXIS_V]);
+  int8_t h = take(&axes[AXIS_H]);
+  if (!(x | y | v | h)) {
+    return;
+  }
+  // Start from QMK's report so held buttons stay down.
+  report_mouse_t report = mousekey_get_report();
+  report.x              = x;
+  report.y              = y;
+  report.v              = v;
+  report.h              = h;
+  host_mouse_send(&report);
+  last_report = timer_read();
+}
+
+static bool moving(void) {
+  for (uint8_t i = 0; i < AXES; i++) {
+    if (axes[i].dir || axes[i].speed || abs(axes[i].pos) >= ONE) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static void update_axes(void) {
+  uint16_t now = timer_read();
+  for (uint8_t i = 0; i < AXES; i++) {
+    axis_t *a   = &axes[i];
+    int8_t  dir = ((held >> (2 * i + 1)) & 1) - ((held >> (2 * i)) & 1);
+    if (dir == a->dir) {
+      continue;
+    }
+    if (dir) {
+      a->since = now;
+      if (a->speed && (a->speed > 0) != (dir > 0)) {
+        a->speed = 0; // reversing cancels the glide
+      }
+      if (!a->speed) {
+        // From rest the first unit goes out on the next tick, like a stock
+        // mouse key press; a tap always moves (or scrolls) at least one.
+        a->pos = dir * (ONE - 1);
+      }
+    }
+    a->dir = dir;
+  }
+  if (!active) {
+    active    = true;
+    last_tick = now;
+    // Let the first whole unit go out without waiting for a report slot.
+    last_report = now - VRMER_MOUSE_REPORT_MS;
+  }
+}
+
+bool vrmer_mouse_process(uint16_t keycode, keyrecord_t *record) {
+  uint8_t *bits = &held;
+  uint8_t  bit;
+  switch (keycode) {
+    case QK_MOUSE_CURSOR_LEFT:
+      bit = 1 << 0;
+      break;
+    case QK_MOUSE_CURSOR_RIGHT:
+      bit = 1 << 1;
+      break;
+    case QK_MOUSE_CURSOR_UP:
+      bit = 1 << 2;
+      break;
+    case QK_MOUSE_CURSOR_DOWN:
+      bit = 1 << 3;
+      break;
+    case QK_MOUSE_WHEEL_DOWN:
+      bit = 1 << 4;
+      break;
+    case QK_MOUSE_WHEEL_UP:
+      bit = 1 << 5;
+      break;
+    case QK_MOUSE_WHEEL_LEFT:
+      bit = 1 << 6;
+      break;
+    case QK_MOUSE_WHEEL_RIGHT:
+      bit = 1 << 7;
+      break;
+    case QK_MOUSE_ACCELERATION_0:
+    case QK_MOUSE_ACCELERATION_1:
+    case QK_MOUSE_ACCELERATION_2:
+      bits = &accel;
+      bit  = 1 << (keycode - QK_MOUSE_ACCELERATION_0);
+      break;
+    default:
+      return true;
+  }
+  if (record->event.pressed) {
+    *bits |= bit;
+  } else {
+    *bits &= ~bit;
+  }
+  update_axes();
+  return false;
+}
+
+void vrmer_mouse_task(void) {
+  if (!active) {
+    return;
+  }
+  uint16_t now   = timer_read();
+  uint8_t  ticks = 0;
+  while (TIMER_DIFF_16(now, last_tick) >= VRMER_MOUSE_TICK_MS) {
+    if (++ticks > MAX_CATCH_UP) {
+      last_tick = now;
+      break;
+    }
+    last_tick += VRMER_MOUSE_TICK_MS;
+    step();
+  }
+  if (TIMER_DIFF_16(now, last_report) >= VRMER_MOUSE_REPORT_MS) {
+    send();
+  }
+  if (!moving()) {
+    active = false;
+    for (uint8_t i = 0; i < AXES; i++) {
+      axes[i].pos = 0; // drop the sub-unit rest
+    }
+  }
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include QMK_KEYBOARD_H
+
+// Kinetic mouse keys.
+//
+// Replaces the movement and wheel part of QMK's mouse keys; buttons stay
+// with QMK. Each axis runs a small physics model on its own
+// VRMER_MOUSE_TICK_MS tick, independent of when reports go out:
+//
+//  - While a direction is held, speed follows an acceleration curve from
+//    the start speed to the top speed over VRMER_MOUSE_TIME_TO_MAX ms, with
+//    VRMER_MOUSE_CURVE picking linear (1), quadratic (2) or cubic (3) easing.
+//    Reversing restarts the curve.
+//  - On release the pointer glides on, losing VRMER_MOUSE_FRICTION/256 of its
+//    speed per millisecond, until it is slower than the start speed. A short
+//    tap therefore stops dead.
+//  - Movement is accumulated in 1/65536 pixel (or wheel unit) steps and only
+//    whole units are reported, so slow speeds move evenly instead of in
+//    bursts and nothing is lost to rounding.
+//
+// Reports go out at most every VRMER_MOUSE_REPORT_MS, which defaults to the
+// USB polling interval. The wheel works in detents unless the mouse
+// descriptor declares a resolution multiplier
+// (POINTING_DEVICE_HIRES_SCROLL_ENABLE), in which case it scrolls in that
+// many units per detent.
+//
+// MS_ACL0 and MS_ACL1 are held for precision: a quarter and half of the
+// start speed, no acceleration and no glide. MS_ACL2 goes straight to top
+// speed.
+//
+// Speeds are in pixels (wheel: detents) per second. The defaults are taken
+// from the MOUSEKEY_* settings Oryx writes to config.h, so the Oryx sliders
+// still set the start speed, top speed and time to top speed.
+
+#ifndef VRMER_MOUSE_TICK_MS
+#    define VRMER_MOUSE_TICK_MS 1
+#endif
+
+#ifndef VRMER_MOUSE_REPORT_MS
+#    define VRMER_MOUSE_REPORT_MS USB_POLLING_INTERVAL_MS
+#endif
+
+#ifndef VRMER_MOUSE_CURVE
+#    define VRMER_MOUSE_CURVE 2
+#endif
+
+#ifndef VRMER_MOUSE_START_SPEED
+#    define VRMER_MOUSE_START_SPEED (MOUSEKEY_MOVE_DELTA * 1000 / MOUSEKEY_INTERVAL)
+#endif
+#ifndef VRMER_MOUSE_MAX_SPEED
+#    define VRMER_MOUSE_MAX_SPEED (MOUSEKEY_MAX_SPEED * MOUSEKEY_MOVE_DELTA * 1000 / MOUSEKEY_INTERVAL)
+#endif
+#ifndef VRMER_MOUSE_TIME_TO_MAX
+#    define VRMER_MOUSE_TIME_TO_MAX (MOUSEKEY_TIME_TO_MAX * MOUSEKEY_INTERVAL)
+#endif
+
+#ifndef VRMER_MOUSE_WHEEL_START_SPEED
+#    define VRMER_MOUSE_WHEEL_START_SPEED (MOUSEKEY_WHEEL_DELTA * 1000 / MOUSEKEY_WHEEL_INTERVAL)
+#endif
+#ifndef VRMER_MOUSE_WHEEL_MAX_SPEED
+#    define VRMER_MOUSE_WHEEL_MAX_SPEED (MOUSEKEY_WHEEL_MAX_SPEED * MOUSEKEY_WHEEL_DELTA * 1000 / MOUSEKEY_WHEEL_INTERVAL)
+#endif
+#ifndef VRMER_MOUSE_WHEEL_TIME_TO_MAX
+#    define VRMER_MOUSE_WHEEL_TIME_TO_MAX (MOUSEKEY_WHEEL_TIME_TO_MAX * MOUSEKEY_WHEEL_INTERVAL)
+#endif
+
+#ifndef VRMER_MOUSE_FRICTION
+#    define VRMER_MOUSE_FRICTION 6
+#endif
+#ifndef VRMER_MOUSE_WHEEL_FRICTION
+#    define VRMER_MOUSE_WHEEL_FRICTION 12
+#endif
+
+// Handle a movement, wheel or acceleration key. Returns false for the keys
+// it takes over; call from process_record_user and return false then.
+bool vrmer_mouse_process(uint16_t keycode, keyrecord_t *record);
+
+// Advance the model and send movement. Call from housekeeping_task_user.
+void vrmer_mouse_task(void);
@@ -0,0 +1,278 @@
+#include "vrmer_overrides.h"
+
+#include "vrmer_rawhid.h"
+#include "vrmer_usage.h"
+
+// One stored copy of the mirror.
+typedef struct {
+  uint8_t           version;
+  uint8_t           reserved;
+  uint16_t          size; // sizeof(vrmer_overrides_t) when written
+  uint16_t          seq;  // the highest valid copy is the current one
+  uint16_t          crc;  // over the whole image, with crc 0
+  vrmer_overrides_t data;
+} image_t;
+
+#define EEPROM_OFFSET(copy) (VRMER_USAGE_EEPROM_SIZE + (copy) * sizeof(image_t))
+
+_Static_assert(EEPROM_OFFSET(VRMER_OVERRIDES_COPIES) <= EECONFIG_USER_DATA_SIZE,
+               "EECONFIG_USER_DATA_SIZE is too small for the overrides");
+
+vrmer_overrides_t vrmer_overrides;
+uint16_t          vrmer_overrides_colour_layers;
+uint8_t           vrmer_overrides_colour_generation;
+
+static uint8_t  copy; // holding the stored state
+static uint16_t seq;
+static uint16_t saved_crc;
+static bool     dirty;
+static uint16_t last_change;
+static image_t  image; // read and write buffer
+
+// CRC-16/CCITT. Runs at boot and per write only.
+static uint16_t crc16(const void *data, uint16_t length) {
+  const uint8_t *p   = data;
+  uint16_t       crc = 0xFFFF;
+  while (length--) {
+    crc ^= (uint16_t)*p++ << 8;
+    for (uint8_t i = 0; i < 8; i++) {
+      crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+  }
+  return crc;
+}
+
+// Covers seq as well, so a write torn between the header and data cannot
+// pass the newer seq off with the older data.
+static uint16_t image_crc(void) {
+  uint16_t stored = image.crc;
+  image.crc       = 0;
+  uint16_t crc    = crc16(&image, sizeof(image));
+  image.crc       = stored;
+  return crc;
+}
+
+static void colours_changed(void) {
+  vrmer_overrides_colour_layers = 0;
+  for (uint8_t i = 0; i < VRMER_OVERRIDES_COLOURS; i++) {
+    uint8_t layer = vrmer_overrides.colours[i].layer;
+    if (layer < 16) {
+      vrmer_overrides_colour_layers |= 1 << layer;
+    }
+  }
+  vrmer_overrides_colour_generation++;
+}
+
+static void changed(void) {
+  dirty       = true;
+  last_change = timer_read();
+}
+
+static void flush(void) {
+  dirty        = false;
+  uint16_t crc = crc16(&vrmer_overrides, sizeof(vrmer_overrides));
+  if (crc == saved_crc) {
+    return; // changed back to what is stored
+  }
+  image.version  = VRMER_OVERRIDES_VERSION;
+  image.reserved = 0;
+  image.size     = sizeof(vrmer_overrides_t);
+  image.seq      = ++seq;
+  image.data     = vrmer_overrides;
+  image.crc      = image_crc();
+  copy           = (copy + 1) % VRMER_OVERRIDES_COPIES;
+  eeconfig_update_user_datablock(&image, EEPROM_OFFSET(copy), sizeof(image));
+  saved_crc = crc;
+}
+
+void vrmer_overrides_init(void) {
+  bool found = false;
+  memset(&vrmer_overrides, 0xff, sizeof(vrmer_overrides));
+  for (uint8_t c = 0; c < VRMER_OVERRIDES_COPIES; c++) {
+    eeconfig_read_user_datablock(&image, EEPROM_OFFSET(c), sizeof(image));
+    if (image.version != VRMER_OVERRIDES_VERSION || image.size != sizeof(vrmer_overrides_t) || image.crc != image_crc()) {
+      continue;
+    }
+    if (!found || (int16_t)(image.seq - seq) > 0) {
+      found           = true;
+      copy            = c;
+      seq             = image.seq;
+      vrmer_overrides = image.data;
+    }
+  }
+  if (!found) {
+    // The next write goes to copy 0.
+    copy = VRMER_OVERRIDES_COPIES - 1;
+  }
+  saved_crc = crc16(&vrmer_overrides, sizeof(vrmer_overrides));
+  colours_changed();
+}
+
+void vrmer_overrides_task(void) {
+  if (dirty && timer_elapsed(last_change) >= VRMER_OVERRIDES_FLUSH_MS) {
+    flush();
+  }
+}
+
+void vrmer_overrides_apply_terms(uint8_t profile, vrmer_profile_t *p) {
+  const uint16_t *t = vrmer_overrides.terms[profile];
+  if (t[VRMER_OVERRIDE_HOME_ROW_TERM] != VRMER_OVERRIDE_NONE) {
+    p->home_row_term = t[VRMER_OVERRIDE_HOME_ROW_TERM];
+  }
+  if (t[VRMER_OVERRIDE_THUMB_TERM] != VRMER_OVERRIDE_NONE) {
+    p->thumb_term = t[VRMER_OVERRIDE_THUMB_TERM];
+  }
+  if (t[VRMER_OVERRIDE_OTHER_TERM] != VRMER_OVERRIDE_NONE) {
+    p->other_term = t[VRMER_OVERRIDE_OTHER_TERM];
+  }
+}
+
+static uint8_t index_count(uint8_t kind) {
+  switch (kind) {
+    case VRMER_OVERRIDE_KIND_TERM:
+      return VRMER_PROFILE_COUNT * VRMER_OVERRIDE_TERMS;
+    case VRMER_OVERRIDE_KIND_SHORTCUT:
+      return vrmer_shortcut_count * 2;
+    default:
+      return VRMER_OVERRIDES_COLOURS;
+  }
+}
+
+static uint16_t default_term(uint8_t index) {
+  vrmer_profile_t p;
+  vrmer_profile_defaults(index / VRMER_OVERRIDE_TERMS, &p);
+  switch (index % VRMER_OVERRIDE_TERMS) {
+    case VRMER_OVERRIDE_HOME_ROW_TERM:
+      return p.home_row_term;
+    case VRMER_OVERRIDE_THUMB_TERM:
+      return p.thumb_term;
+    default:
+      return p.other_term;
+  }
+}
+
+static uint8_t *put16(uint8_t *p, uint16_t v) {
+  *p++ = v & 0xff;
+  *p++ = v >> 8;
+  return p;
+}
+
+void vrmer_overrides_hid_read(uint8_t *data) {
+  uint8_t kind  = data[1];
+  uint8_t index = data[2];
+  memset(data + 1, 0, RAW_EPSIZE - 1);
+  if (kind >= VRMER_OVERRIDE_KINDS || index >= index_count(kind)) {
+    data[1] = VRMER_HID_BAD_ARGUMENT;
+    return;
+  }
+
+  uint8_t *p = data + 1;
+  *p++       = VRMER_HID_OK;
+  *p++       = kind;
+  *p++       = index;
+  *p++       = index_count(kind);
+  switch (kind) {
+    case VRMER_OVERRIDE_KIND_TERM: {
+      uint16_t value = vrmer_overrides.terms[index / VRMER_OVERRIDE_TERMS][index % VRMER_OVERRIDE_TERMS];
+      *p++           = value != VRMER_OVERRIDE_NONE;
+      p              = put16(p, value);
+      put16(p, default_term(index));
+      break;
+    }
+    case VRMER_OVERRIDE_KIND_SHORTCUT: {
+      uint16_t value = vrmer_overrides.shortcuts[index / 2][index % 2];
+      *p++           = value != VRMER_OVERRIDE_NONE;
+      p              = put16(p, value);
+      put16(p, pgm_read_word(&vrmer_shortcuts[index / 2][index % 2]));
+      break;
+    }
+    case VRMER_OVERRIDE_KIND_COLOUR: {
+      const vrmer_colour_override_t *c = &vrmer_overrides.colours[index];
+      *p++                             = c->layer != VRMER_OVERRIDE_NONE_LAYER;
+      memcpy(p, c, sizeof(*c));
+      break;
+    }
+  }
+}
+
+// Entry for a colour override of (layer, led): the existing one, else a free
+// one if add is set. NULL if there is none.
+static vrmer_colour_override_t *colour_entry(uint8_t layer, uint8_t led, bool add) {
+  vrmer_colour_override_t *free = NULL;
+  for (uint8_t i = 0; i < VRMER_OVERRIDES_COLOURS; i++) {
+    vrmer_colour_override_t *c = &vrmer_overrides.colours[i];
+    if (c->layer == layer && c->led == led) {
+      return c;
+    }
+    if (!free && c->layer == VRMER_OVERRIDE_NONE_LAYER) {
+      free = c;
+    }
+  }
+  return add ? free : NULL;
+}
+
+static uint8_t write_colour(uint8_t led, bool set, const uint8_t *hsv) {
+  uint8_t layer = hsv[0];
+  if (layer >= 16 || led >= RGB_MATRIX_LED_COUNT) {
+    return VRMER_HID_BAD_ARGUMENT;
+  }
+  vrmer_colour_override_t *c = colour_entry(layer, led, set);
+  if (!c) {
+    return set ? VRMER_HID_NO_SPACE : VRMER_HID_OK;
+  }
+  if (set) {
+    *c = (vrmer_colour_override_t){layer, led, hsv[1], hsv[2], hsv[3]};
+  } else {
+    memset(c, 0xff, sizeof(*c));
+  }
+  colours_changed();
+  return VRMER_HID_OK;
+}
+
+void vrmer_overrides_hid_write(uint8_t *data) {
+  uint8_t  kind   = data[1];
+  uint8_t  index  = data[2];
+  bool     set    = data[3];
+  uint16_t value  = set ? data[4] | data[5] << 8 : VRMER_OVERRIDE_NONE;
+  uint8_t  status = VRMER_HID_OK;
+
+  if (kind >= VRMER_OVERRIDE_KINDS || (kind != VRMER_OVERRIDE_KIND_COLOUR && index >= index_count(kind))) {
+    status = VRMER_HID_BAD_ARGUMENT;
+  } else if (kind == VRMER_OVERRIDE_KIND_TERM) {
+    if (set && (value == 0 || value > VRMER_OVERRIDES_TERM_MAX)) {
+      status = VRMER_HID_BAD_ARGUMENT;
+    } else {
+      vrmer_overrides.terms[index / VRMER_OVERRIDE_TERMS][index % VRMER_OVERRIDE_TERMS] = value;
+      vrmer_profile_reload_terms();
+    }
+  } else if (kind == VRMER_OVERRIDE_KIND_SHORTCUT) {
+    vrmer_overrides.shortcuts[index / 2][index % 2] = value;
+  } else {
+    status = write_colour(index, set, data + 4);
+  }
+  if (status == VRMER_HID_OK) {
+    changed();
+  }
+
+  memset(data + 1, 0, RAW_EPSIZE - 1);
+  data[1] = status;
+}
+
+void vrmer_overrides_hid_reset(uint8_t *data) {
+  memset(&vrmer_overrides, 0xff, sizeof(vrmer_overrides));
+  vrmer_profile_reload_terms();
+  colours_changed();
+  changed();
+  memset(data + 1, 0, RAW_EPSIZE - 1);
+  data[1] = VRMER_HID_OK;
+}
+
+void vrmer_overrides_hid_save(uint8_t *data) {
+  if (dirty) {
+    flush();
+  }
+  memset(data + 1, 0, RAW_EPSIZE - 1);
+  data[1] = VRMER_HID_OK;
+  data[2] = copy;
+  put16(data + 3, seq);
+}
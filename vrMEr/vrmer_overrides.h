@@ -0,0 +1,117 @@
+#pragma once
+
+#include QMK_KEYBOARD_H
+
+#include "vrmer_profile.h"
+
+// Runtime overrides for tapping terms, shortcut chords and layer colours.
+//
+// The compile-time values stay the defaults: the profile terms of
+// vrmer_profile.c, the vrmer_shortcuts table and the ledmap. An override
+// replaces one of them without a reflash. Overrides are set over raw HID
+// (see vrmer_rawhid.h and `tools/rawhid/vrmer_hid.py override`) and kept in
+// the EEPROM user datablock, after the usage counters.
+//
+// keyboard_post_init_user loads them into vrmer_overrides, and only that RAM
+// mirror is read afterwards: term overrides are folded into vrmer_profile
+// when a profile is applied, and chords and colours are looked up in RAM.
+//
+// Writing is batched. A change only marks the mirror dirty; it is written
+// once no change came for VRMER_OVERRIDES_FLUSH_MS, or right away on
+// VRMER_HID_OVERRIDES_SAVE, so setting many values costs one write. Each
+// write goes to the next of VRMER_OVERRIDES_COPIES copies with a higher
+// sequence number and a CRC over the whole copy, which spreads the wear over
+// the copies and leaves the previous copy to load if power goes mid-write. A
+// copy written by a firmware with another layout (version or size) is
+// ignored.
+
+#ifndef VRMER_OVERRIDES_SHORTCUTS
+#    define VRMER_OVERRIDES_SHORTCUTS 56
+#endif
+
+#ifndef VRMER_OVERRIDES_COLOURS
+#    define VRMER_OVERRIDES_COLOURS 24
+#endif
+
+#ifndef VRMER_OVERRIDES_COPIES
+#    define VRMER_OVERRIDES_COPIES 2
+#endif
+
+#ifndef VRMER_OVERRIDES_FLUSH_MS
+#    define VRMER_OVERRIDES_FLUSH_MS 3000
+#endif
+
+// Longest tapping term an override may set.
+#ifndef VRMER_OVERRIDES_TERM_MAX
+#    define VRMER_OVERRIDES_TERM_MAX 1000
+#endif
+
+// Bumped whenever the stored layout changes.
+#define VRMER_OVERRIDES_VERSION 2
+
+// Value of a term or chord that is not overridden, and layer of an unused
+// colour entry.
+#define VRMER_OVERRIDE_NONE       0xFFFF
+#define VRMER_OVERRIDE_NONE_LAYER 0xFF
+
+enum vrmer_override_term {
+  VRMER_OVERRIDE_HOME_ROW_TERM,
+  VRMER_OVERRIDE_THUMB_TERM,
+  VRMER_OVERRIDE_OTHER_TERM,
+  VRMER_OVERRIDE_TERMS,
+};
+
+enum vrmer_override_kind {
+  VRMER_OVERRIDE_KIND_TERM,     // index: profile * VRMER_OVERRIDE_TERMS + term
+  VRMER_OVERRIDE_KIND_SHORTCUT, // index: shortcut * 2 + vrmer_os
+  VRMER_OVERRIDE_KIND_COLOUR,   // index: entry to read, LED to write
+  VRMER_OVERRIDE_KINDS,
+};
+
+typedef struct {
+  uint8_t layer; // VRMER_OVERRIDE_NONE_LAYER when unused
+  uint8_t led;
+  uint8_t h;
+  uint8_t s;
+  uint8_t v;
+} vrmer_colour_override_t;
+
+typedef struct {
+  uint16_t                terms[VRMER_PROFILE_COUNT][VRMER_OVERRIDE_TERMS];
+  uint16_t                shortcuts[VRMER_OVERRIDES_SHORTCUTS][2];
+  vrmer_colour_override_t colours[VRMER_OVERRIDES_COLOURS];
+} vrmer_overrides_t;
+
+extern vrmer_overrides_t vrmer_overrides;
+
+// Layers with a colour override, and a counter bumped on every colour change
+// so cached frames can be rebuilt.
+extern uint16_t vrmer_overrides_colour_layers;
+extern uint8_t  vrmer_overrides_colour_generation;
+
+// Chord table of the layout, {macOS, Windows} per shortcut keycode.
+extern const uint16_t vrmer_shortcuts[][2];
+extern const uint8_t  vrmer_shortcut_count;
+
+// Load the newest valid copy from EEPROM. Call from keyboard_post_init_user
+// before vrmer_profile_init.
+void vrmer_overrides_init(void);
+
+// Write the mirror once it has been left alone for VRMER_OVERRIDES_FLUSH_MS.
+// Call from housekeeping_task_user.
+void vrmer_overrides_task(void);
+
+// Replace the terms of a profile with their overrides.
+void vrmer_overrides_apply_terms(uint8_t profile, vrmer_profile_t *p);
+
+// Chord for a shortcut keycode (keycode - OS_UNDO) on an OS.
+static inline uint16_t vrmer_overrides_chord(uint8_t shortcut, uint8_t os) {
+  uint16_t chord = vrmer_overrides.shortcuts[shortcut][os];
+  return chord != VRMER_OVERRIDE_NONE ? chord : pgm_read_word(&vrmer_shortcuts[shortcut][os]);
+}
+
+// Raw HID handlers. They rewrite the RAW_EPSIZE packet in data into the reply.
+void vrmer_overrides_hid_read(uint8_t *data);
+void vrmer_overrides_hid_write(uint8_t *data);
+void vrmer_overrides_hid_reset(uint8_t *data);
+void vrmer_overrides_hid_save(uint8_t *data);
@@ -0,0 +1,95 @@
+#include "vrmer_profile.h"
+
+#include "vrmer_overrides.h"
+
+// Layout of the 32-bit EEPROM user word.
+typedef union {
+  uint32_t raw;
+  struct {
+    uint8_t profile : 3;
+  };
+} vrmer_user_config_t;
+
+static const vrmer_profile_t PROGMEM profiles[VRMER_PROFILE_COUNT] = {
+  [VRMER_PROFILE_BALANCED] = {
+    .home_row_term = VRMER_HOME_ROW_TERM,
+    .thumb_term    = VRMER_THUMB_TERM,
+    .other_term    = TAPPING_TERM,
+    .rgb           = VRMER_PROFILE_RGB_FULL,
+  },
+  // Shorter terms and no animated effect: hold/tap settles sooner and the
+  // scan loop spends less time rendering.
+  [VRMER_PROFILE_LOW_LATENCY] = {
+    .home_row_term = VRMER_HOME_ROW_TERM - 25,
+    .thumb_term    = VRMER_THUMB_TERM - 30,
+    .other_term    = TAPPING_TERM - 20,
+    .rgb           = VRMER_PROFILE_RGB_SOLID,
+  },
+  // Default terms with the LEDs off.
+  [VRMER_PROFILE_QUIET] = {
+    .home_row_term = VRMER_HOME_ROW_TERM,
+    .thumb_term    = VRMER_THUMB_TERM,
+    .other_term    = TAPPING_TERM,
+    .rgb           = VRMER_PROFILE_RGB_OFF,
+  },
+};
+
+vrmer_profile_t vrmer_profile;
+
+static vrmer_user_config_t user_config;
+
+void vrmer_profile_defaults(uint8_t id, vrmer_profile_t *p) {
+  memcpy_P(p, &profiles[id], sizeof(*p));
+}
+
+void vrmer_profile_reload_terms(void) {
+  vrmer_profile_t p;
+  vrmer_profile_defaults(user_config.profile, &p);
+  vrmer_overrides_apply_terms(user_config.profile, &p);
+  vrmer_profile.home_row_term = p.home_row_term;
+  vrmer_profile.thumb_term    = p.thumb_term;
+  vrmer_profile.other_term    = p.other_term;
+}
+
+static void apply(void) {
+  vrmer_profile_defaults(user_config.profile, &vrmer_profile);
+  vrmer_overrides_apply_terms(user_config.profile, &vrmer_profile);
+
+  // Only the live RGB config is touched, so leaving the profile brings back
+  // whatever was saved.
+  rgb_matrix_reload_from_eeprom();
+  switch (vrmer_profile.rgb) {
+    case VRMER_PROFILE_RGB_SOLID:
+      rgb_matrix_mode_noeeprom(RGB_MATRIX_SOLID_COLOR);
+      break;
+    case VRMER_PROFILE_RGB_OFF:
+      rgb_matrix_disable_noeeprom();
+      break;
+  }
+}
+
+void eeconfig_init_user(void) {
+  user_config.raw = 0;
+  eeconfig_update_user(user_config.raw);
+}
+
+void vrmer_profile_init(void) {
+  user_config.raw = eeconfig_read_user();
+  if (user_config.profile >= VRMER_PROFILE_COUNT) {
+    user_config.profile = VRMER_PROFILE_BALANCED;
+  }
+  apply();
+}
+
+void vrmer_profile_select(uint8_t id) {
+  if (id >= VRMER_PROFILE_COUNT || id == user_config.profile) {
+    return;
+  }
+  user_config.profile = id;
+  eeconfig_update_user(user_config.raw);
+  apply();
+}
+
+uint8_t vrmer_profile_id(void) {
+  return user_config.profile;
+}
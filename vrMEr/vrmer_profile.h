@@ -0,0 +1,62 @@
+#pragma once
+
+#include QMK_KEYBOARD_H
+
+// Runtime performance profiles.
+//
+// A profile bundles the settings that trade responsiveness against RGB work
+// and power: the tapping terms handed out by get_tapping_term and how much
+// the RGB matrix renders. The PF_* keys on LAYER_CONFIG switch profiles; the
+// choice is kept in the EEPROM user word and applied again at boot. The terms
+// of each profile can be overridden at runtime, see vrmer_overrides.h.
+//
+// USB_POLLING_INTERVAL_MS is not part of a profile: it ends up in the USB
+// endpoint descriptor, which the host reads once at enumeration.
+
+// Home-row mod and space layer-tap terms of the balanced profile; the others
+// are derived from them.
+#ifndef VRMER_HOME_ROW_TERM
+#    define VRMER_HOME_ROW_TERM 200
+#endif
+
+#ifndef VRMER_THUMB_TERM
+#    define VRMER_THUMB_TERM 230
+#endif
+
+enum vrmer_profiles {
+  VRMER_PROFILE_BALANCED, // compile-time defaults; what a fresh EEPROM gets
+  VRMER_PROFILE_LOW_LATENCY,
+  VRMER_PROFILE_QUIET,
+  VRMER_PROFILE_COUNT,
+};
+
+enum vrmer_profile_rgb {
+  VRMER_PROFILE_RGB_FULL,  // the effect saved in the RGB config
+  VRMER_PROFILE_RGB_SOLID, // solid colour under the layer colours
+  VRMER_PROFILE_RGB_OFF,
+};
+
+typedef struct {
+  uint16_t home_row_term;
+  uint16_t thumb_term;
+  uint16_t other_term;
+  uint8_t  rgb;
+} vrmer_profile_t;
+
+// Settings of the active profile, kept in RAM for the tapping-term hot path.
+extern vrmer_profile_t vrmer_profile;
+
+// Load the stored profile and apply it. Call from keyboard_post_init_user
+// after the RGB matrix is set up.
+void vrmer_profile_init(void);
+
+// Switch to a profile, apply it and store it in EEPROM.
+void vrmer_profile_select(uint8_t id);
+
+uint8_t vrmer_profile_id(void);
+
+// Compile-time settings of a profile, without overrides.
+void vrmer_profile_defaults(uint8_t id, vrmer_profile_t *p);
+
+// Pick up changed term overrides for the active profile.
+void vrmer_profile_reload_terms(void);
@@ -0,0 +1,76 @@
+#include "vrmer_rawhid.h"
+
+#include "vrmer_debounce.h"
+#include "vrmer_latency.h"
+#include "vrmer_looptime.h"
+#include "vrmer_overrides.h"
+#include "vrmer_telemetry.h"
+#include "vrmer_usage.h"
+
+void __real_raw_hid_receive(uint8_t *data, uint8_t length);
+
+static void oryx_receive(uint8_t *data, uint8_t length) {
+  uint32_t start = vrmer_looptime_start();
+  __real_raw_hid_receive(data, length);
+  vrmer_looptime_stop(VRMER_LOOPTIME_ORYX, start);
+}
+
+void __wrap_raw_hid_receive(uint8_t *data, uint8_t length) {
+  if (length < RAW_EPSIZE) {
+    oryx_receive(data, length);
+    return;
+  }
+  switch (data[0]) {
+    case VRMER_HID_LATENCY_READ:
+      vrmer_latency_hid_read(data);
+      break;
+    case VRMER_HID_LATENCY_RESET:
+      vrmer_latency_hid_reset(data);
+      break;
+    case VRMER_HID_USAGE_READ:
+      vrmer_usage_hid_read(data);
+      break;
+    case VRMER_HID_USAGE_RESET:
+      vrmer_usage_hid_reset(data);
+      break;
+#ifdef VRMER_LOOPTIME_ENABLE
+    case VRMER_HID_LOOPTIME_READ:
+      vrmer_looptime_hid_read(data);
+      break;
+    case VRMER_HID_LOOPTIME_RESET:
+      vrmer_looptime_hid_reset(data);
+      break;
+#endif
+    case VRMER_HID_TELEMETRY_START:
+      vrmer_telemetry_hid_start(data);
+      break;
+    case VRMER_HID_TELEMETRY_STOP:
+      vrmer_telemetry_hid_stop(data);
+      break;
+    case VRMER_HID_TELEMETRY_ACK:
+      vrmer_telemetry_hid_ack(data);
+      return;
+    case VRMER_HID_OVERRIDES_READ:
+      vrmer_overrides_hid_read(data);
+      break;
+    case VRMER_HID_OVERRIDES_WRITE:
+      vrmer_overrides_hid_write(data);
+      break;
+    case VRMER_HID_OVERRIDES_RESET:
+      vrmer_overrides_hid_reset(data);
+      break;
+    case VRMER_HID_OVERRIDES_SAVE:
+      vrmer_overrides_hid_save(data);
+      break;
+    case VRMER_HID_DEBOUNCE_READ:
+      vrmer_debounce_hid_read(data);
+      break;
+    case VRMER_HID_DEBOUNCE_RESET:
+      vrmer_debounce_hid_reset(data);
+      break;
+    default:
+      oryx_receive(data, length);
+      return;
+  }
+  raw_hid_send(data, length);
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include QMK_KEYBOARD_H
+
+#include "raw_hid.h"
+#include "usb_descriptor.h"
+
+// Vendor raw HID commands.
+//
+// Oryx owns raw_hid_receive, so rules.mk links with
+// -Wl,--wrap=raw_hid_receive and the wrapper in vrmer_rawhid.c picks off the
+// commands below before handing everything else to Oryx. Command ids sit well
+// above the Oryx protocol's so the two never collide.
+//
+// Every packet is RAW_EPSIZE bytes. A reply echoes the command id in byte 0,
+// carries a vrmer_hid_status in byte 1 and the payload after it. Multi-byte
+// values are little endian.
+
+enum vrmer_hid_command {
+  // -> [class]
+  // <- [class, bucket count, bucket counts as u16..., max ms u16, total ms u32]
+  VRMER_HID_LATENCY_READ = 0xD0,
+  // Clears both latency histograms.
+  VRMER_HID_LATENCY_RESET,
+  // -> [table, first slot]
+  // <- [layer count, table, first slot, n, n counters as u16...]
+  // Tables 0..layer count-1 hold presses per layer, then taps and holds of
+  // tap-hold keys, each indexed by slot k00..k51 (see vrmer_usage.h).
+  VRMER_HID_USAGE_READ,
+  // Clears all usage counters, in RAM and EEPROM.
+  VRMER_HID_USAGE_RESET,
+  // -> [section]
+  // <- [section count, section, loop passes per second u16, calls u32,
+  //     avg ns u32, max ns u32, share of time since reset in 1/100 % u16]
+  // Only with VRMER_LOOPTIME_ENABLE, see vrmer_looptime.h.
+  VRMER_HID_LOOPTIME_READ,
+  // Clears the loop profile.
+  VRMER_HID_LOOPTIME_RESET,
+  // -> [min ms between packets]
+  // <- [window]
+  // Starts (or restarts) the state stream, see vrmer_telemetry.h.
+  VRMER_HID_TELEMETRY_START,
+  VRMER_HID_TELEMETRY_STOP,
+  // -> [seq of the last packet received]
+  // No reply; also keeps the stream alive.
+  VRMER_HID_TELEMETRY_ACK,
+  // <- [seq, ms u16, layer_state u16, default_layer_state u16, mods,
+  //     one-shot mods, flags, held slots[7], slots pressed since the last
+  //     packet[7], key events since the last packet]
+  // Sent by the keyboard unasked, with seq in place of the status byte.
+  // Slot n is bit n & 7 of byte n >> 3; flags are caps word (bit 0), leader
+  // sequence (bit 1) and one-shot layer waiting (bit 2).
+  VRMER_HID_TELEMETRY_STATE,
+  // -> [kind, index]
+  // <- [kind, index, index count, set, value...]
+  // Runtime overrides, see vrmer_overrides.h. For terms (kind 0, index
+  // profile * 3 + home row/thumb/other) and chords (kind 1, index
+  // shortcut * 2 + mac/win) the value is the override u16 and the default
+  // u16; for colours (kind 2, index entry) it is layer, LED, h, s, v.
+  VRMER_HID_OVERRIDES_READ,
+  // -> [kind, index, set, value...]
+  // Sets (set = 1) or clears an override: a term or chord u16, or for a
+  // colour index is the LED and the value is layer, h, s, v. Written to
+  // EEPROM later, see VRMER_HID_OVERRIDES_SAVE.
+  VRMER_HID_OVERRIDES_WRITE,
+  // Clears every override.
+  VRMER_HID_OVERRIDES_RESET,
+  // <- [copy, seq u16]
+  // Writes pending changes to EEPROM now and tells where they went.
+  VRMER_HID_OVERRIDES_SAVE,
+  // -> [first slot]
+  // <- [DEBOUNCE ms, bounce total u16, first slot, n, n counters as u8...]
+  // Bounces dropped per key by the custom debounce, see vrmer_debounce.h.
+  VRMER_HID_DEBOUNCE_READ,
+  // Clears the bounce counters.
+  VRMER_HID_DEBOUNCE_RESET,
+};
+
+enum vrmer_hid_status {
+  VRMER_HID_OK,
+  VRMER_HID_BAD_ARGUMENT,
+  VRMER_HID_NO_SPACE,
+};
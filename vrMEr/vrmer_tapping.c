@@ -0,0 +1,65 @@
+#include "vrmer_tapping.h"
+
+enum {
+  HAND_LEFT,
+  HAND_RIGHT,
+  HAND_COUNT,
+};
+
+typedef struct {
+  bool     active;
+  uint16_t last_press;
+  uint16_t ewma; // ms << 4
+} hand_state_t;
+
+static hand_state_t hands[HAND_COUNT];
+
+// Burst cap captured at each key's press, in ms. 0 means the hand was idle
+// (or slow enough) and the configured term applies.
+static uint8_t press_cap[MATRIX_ROWS][MATRIX_COLS];
+
+static uint8_t key_hand(keypos_t key) {
+  return key.row < MATRIX_ROWS / 2 ? HAND_LEFT : HAND_RIGHT;
+}
+
+void vrmer_tapping_record(keyrecord_t *record) {
+  keypos_t key = record->event.key;
+  if (!record->event.pressed || key.row >= MATRIX_ROWS || key.col >= MATRIX_COLS) {
+    return;
+  }
+
+  hand_state_t *hand = &hands[key_hand(key)];
+  uint16_t      now  = record->event.time;
+  uint16_t      gap  = TIMER_DIFF_16(now, hand->last_press);
+  uint8_t       cap  = 0;
+
+  if (hand->active && gap < VRMER_TAPPING_IDLE_MS) {
+    int32_t ewma = hand->ewma;
+    ewma += (((int32_t)gap << 4) - ewma) >> VRMER_TAPPING_EWMA_SHIFT;
+    hand->ewma = (uint16_t)ewma;
+
+    uint16_t average = hand->ewma >> 4;
+    if (average < VRMER_TAPPING_TERM_MIN) {
+      average = VRMER_TAPPING_TERM_MIN;
+    }
+    if (average < UINT8_MAX) {
+      cap = (uint8_t)average;
+    }
+  } else {
+    // First press of a burst: start the average at the idle threshold so a
+    // single quick press doesn't shrink the term on its own.
+    hand->ewma   = VRMER_TAPPING_IDLE_MS << 4;
+    hand->active = true;
+  }
+  hand->last_press            = now;
+  press_cap[key.row][key.col] = cap;
+}
+
+uint16_t vrmer_tapping_term(uint16_t configured, keyrecord_t *record) {
+  keypos_t key = record->event.key;
+  if (key.row >= MATRIX_ROWS || key.col >= MATRIX_COLS) {
+    return configured;
+  }
+  uint8_t cap = press_cap[key.row][key.col];
+  return cap && cap < configured ? cap : configured;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include QMK_KEYBOARD_H
+
+// Typing-speed-aware tapping term.
+//
+// Every key press updates an exponentially weighted average of the interval
+// between presses on the same hand. While a hand is in a typing burst, keys
+// on that hand get a tapping term no longer than that average, so fast rolls
+// resolve sooner. After VRMER_TAPPING_IDLE_MS without a press the hand falls
+// back to the configured terms. The term is fixed when a key goes down, so it
+// does not move while that key is still undecided.
+
+// Shortest term the burst logic will hand out.
+#ifndef VRMER_TAPPING_TERM_MIN
+#    define VRMER_TAPPING_TERM_MIN TAPPING_TERM
+#endif
+
+// A gap this long between two presses on one hand ends a burst.
+#ifndef VRMER_TAPPING_IDLE_MS
+#    define VRMER_TAPPING_IDLE_MS 500
+#endif
+
+// Weight of the newest interval in the average, as a right shift (1 = 1/2).
+#ifndef VRMER_TAPPING_EWMA_SHIFT
+#    define VRMER_TAPPING_EWMA_SHIFT 1
+#endif
+
+// Feed a matrix event to the engine. Call from pre_process_record_user so it
+// sees presses in matrix order, before combos and tap-hold buffering.
+void vrmer_tapping_record(keyrecord_t *record);
+
+// Effective term for the key in record, given its configured term.
+uint16_t vrmer_tapping_term(uint16_t configured, keyrecord_t *record);
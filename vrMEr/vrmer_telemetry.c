@@ -0,0 +1,157 @@
+#include "vrmer_telemetry.h"
+
+#include <string.h>
+
+#include "vrmer_keymap.h"
+#include "vrmer_rawhid.h"
+
+#define SLOT_BYTES ((VOYAGER_SLOT_COUNT + 7) / 8)
+
+enum {
+  FLAG_CAPS_WORD     = 1 << 0,
+  FLAG_LEADER        = 1 << 1,
+  FLAG_ONESHOT_LAYER = 1 << 2,
+};
+
+typedef struct {
+  uint16_t layers;
+  uint16_t default_layers;
+  uint8_t  mods;
+  uint8_t  oneshot_mods;
+  uint8_t  flags;
+  uint8_t  held[SLOT_BYTES];
+} state_t;
+
+static bool     listening;
+static uint16_t lease_start;
+static uint8_t  min_gap; // ms between packets, from the host
+static uint16_t last_sent;
+static uint8_t  seq;   // of the next packet
+static uint8_t  acked; // seq of the first packet not acknowledged
+
+static state_t sent; // as of the last packet
+static uint8_t held[SLOT_BYTES];
+static uint8_t pressed[SLOT_BYTES]; // since the last packet
+static uint8_t events;              // since the last packet
+
+void vrmer_telemetry_record(keyrecord_t *record) {
+  if (!listening || record->event.type != KEY_EVENT) {
+    return;
+  }
+  uint8_t slot = vrmer_keymap_slot(record->event.key);
+  if (slot == VOYAGER_NO_SLOT) {
+    return;
+  }
+  uint8_t bit = 1 << (slot & 7);
+  if (record->event.pressed) {
+    held[slot >> 3] |= bit;
+    pressed[slot >> 3] |= bit;
+  } else {
+    held[slot >> 3] &= ~bit;
+  }
+  if (events < UINT8_MAX) {
+    events++;
+  }
+}
+
+static void read_state(state_t *s) {
+  s->layers         = layer_state;
+  s->default_layers = default_layer_state;
+  s->mods           = get_mods();
+  s->oneshot_mods   = get_oneshot_mods();
+  s->flags          = is_oneshot_layer_active() ? FLAG_ONESHOT_LAYER : 0;
+#ifdef CAPS_WORD_ENABLE
+  if (is_caps_word_on()) {
+    s->flags |= FLAG_CAPS_WORD;
+  }
+#endif
+#ifdef LEADER_ENABLE
+  if (leader_sequence_active()) {
+    s->flags |= FLAG_LEADER;
+  }
+#endif
+  memcpy(s->held, held, SLOT_BYTES);
+}
+
+static void stop(void) {
+  listening = false;
+}
+
+void vrmer_telemetry_task(void) {
+  if (!listening) {
+    return;
+  }
+  uint16_t now = timer_read();
+  if (TIMER_DIFF_16(now, lease_start) >= VRMER_TELEMETRY_LEASE_MS) {
+    stop();
+    return;
+  }
+  if ((uint8_t)(seq - acked) >= VRMER_TELEMETRY_WINDOW || TIMER_DIFF_16(now, last_sent) < min_gap) {
+    return;
+  }
+  state_t state;
+  memset(&state, 0, sizeof(state));
+  read_state(&state);
+  if (!events && !memcmp(&state, &sent, sizeof(state))) {
+    return;
+  }
+
+  uint8_t  data[RAW_EPSIZE] = {VRMER_HID_TELEMETRY_STATE, seq++};
+  uint8_t *p                = data + 2;
+  *p++                      = now & 0xff;
+  *p++                      = now >> 8;
+  *p++                      = state.layers & 0xff;
+  *p++                      = state.layers >> 8;
+  *p++                      = state.default_layers & 0xff;
+  *p++                      = state.default_layers >> 8;
+  *p++                      = state.mods;
+  *p++                      = state.oneshot_mods;
+  *p++                      = state.flags;
+  memcpy(p, state.held, SLOT_BYTES);
+  p += SLOT_BYTES;
+  memcpy(p, pressed, SLOT_BYTES);
+  p += SLOT_BYTES;
+  *p = events;
+  raw_hid_send(data, RAW_EPSIZE);
+
+  sent      = state;
+  last_sent = now;
+  events    = 0;
+  memset(pressed, 0, SLOT_BYTES);
+}
+
+void vrmer_telemetry_hid_start(uint8_t *data) {
+  min_gap     = data[1];
+  listening   = true;
+  lease_start = timer_read();
+  last_sent   = lease_start - min_gap;
+  acked       = seq;
+  // Keys held from before the start are not known; the first packet goes
+  // out right away with what is.
+  memset(held, 0, SLOT_BYTES);
+  memset(pressed, 0, SLOT_BYTES);
+  memset(&sent, 0xff, sizeof(sent));
+  events = 0;
+
+  memset(data + 1, 0, RAW_EPSIZE - 1);
+  data[1] = VRMER_HID_OK;
+  data[2] = VRMER_TELEMETRY_WINDOW;
+}
+
+void vrmer_telemetry_hid_stop(uint8_t *data) {
+  stop();
+  memset(data + 1, 0, RAW_EPSIZE - 1);
+  data[1] = VRMER_HID_OK;
+}
+
+void vrmer_telemetry_hid_ack(const uint8_t *data) {
+  if (!listening) {
+    return;
+  }
+  // Ignore acknowledgements for packets not sent yet.
+  uint8_t next = data[1] + 1;
+  if ((uint8_t)(next - acked) <= (uint8_t)(seq - acked)) {
+    acked = next;
+  }
+  lease_start = timer_read();
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include QMK_KEYBOARD_H
+
+// Live state stream over raw HID.
+//
+// A host that sends VRMER_HID_TELEMETRY_START gets a VRMER_HID_TELEMETRY_STATE
+// packet whenever the layer state, the mods, the one-shot or caps word state
+// or the set of held keys changes (see vrmer_rawhid.h for the layout). Held
+// keys are LAYOUT_voyager slots, and a key pressed and released between two
+// packets still shows up in the pressed-since bitmap.
+//
+// Nothing is tracked until a host starts the stream, so without one the
+// cost is a flag test per key event and per housekeeping pass.
+//
+// Packets are sent from housekeeping_task_user and never block on the
+// endpoint: at most VRMER_TELEMETRY_WINDOW packets are sent ahead of the
+// host's last VRMER_HID_TELEMETRY_ACK. While the window is full, changes are
+// folded into the next packet instead. The host may also ask for a minimum
+// gap between packets. A stream the host has not acknowledged or restarted
+// for VRMER_TELEMETRY_LEASE_MS ends by itself.
+
+#ifndef VRMER_TELEMETRY_WINDOW
+#    define VRMER_TELEMETRY_WINDOW 4
+#endif
+
+#ifndef VRMER_TELEMETRY_LEASE_MS
+#    define VRMER_TELEMETRY_LEASE_MS 2000
+#endif
+
+// Note a matrix event. Call from pre_process_record_user.
+void vrmer_telemetry_record(keyrecord_t *record);
+
+// Send the state if it changed. Call from housekeeping_task_user.
+void vrmer_telemetry_task(void);
+
+// Raw HID handlers. They rewrite the RAW_EPSIZE packet in data into the reply.
+void vrmer_telemetry_hid_start(uint8_t *data);
+void vrmer_telemetry_hid_stop(uint8_t *data);
+
+// Acknowledge packets up to a sequence number; has no reply.
+void vrmer_telemetry_hid_ack(const uint8_t *data);
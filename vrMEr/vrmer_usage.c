@@ -0,0 +1,100 @@
+#include "vrmer_usage.h"
+
+#include "vrmer_rawhid.h"
+
+_Static_assert(VRMER_USAGE_EEPROM_SIZE <= EECONFIG_USER_DATA_SIZE,
+               "EECONFIG_USER_DATA_SIZE is too small for the usage counters");
+
+#define BLOCKS ((VRMER_USAGE_EEPROM_SIZE + VRMER_USAGE_BLOCK - 1) / VRMER_USAGE_BLOCK)
+
+// Counters per HID reply: 32 bytes less command, status and a 4-byte header.
+#define HID_COUNTERS ((RAW_EPSIZE - 6) / 2)
+
+static uint16_t counters[VRMER_USAGE_TABLES][VOYAGER_SLOT_COUNT];
+static uint8_t  dirty[(BLOCKS + 7) / 8];
+static bool     any_dirty;
+static uint32_t last_flush;
+
+static void bump(uint8_t table, uint8_t slot) {
+  uint16_t *c = &counters[table][slot];
+  if (*c == UINT16_MAX) {
+    return;
+  }
+  (*c)++;
+  uint16_t block = (uint16_t)((uint8_t *)c - (uint8_t *)counters) / VRMER_USAGE_BLOCK;
+  dirty[block / 8] |= 1 << (block % 8);
+  any_dirty = true;
+}
+
+static void flush(void) {
+  for (uint16_t block = 0; block < BLOCKS; block++) {
+    if (!(dirty[block / 8] & (1 << (block % 8)))) {
+      continue;
+    }
+    uint16_t offset = block * VRMER_USAGE_BLOCK;
+    uint16_t length = MIN(VRMER_USAGE_BLOCK, VRMER_USAGE_EEPROM_SIZE - offset);
+    eeconfig_update_user_datablock((uint8_t *)counters + offset, offset, length);
+  }
+  memset(dirty, 0, sizeof(dirty));
+  any_dirty  = false;
+  last_flush = timer_read32();
+}
+
+void vrmer_usage_init(void) {
+  eeconfig_read_user_datablock(counters, 0, sizeof(counters));
+  last_flush = timer_read32();
+}
+
+void vrmer_usage_record(uint16_t keycode, keyrecord_t *record) {
+  if (!record->event.pressed || record->event.type == COMBO_EVENT) {
+    return;
+  }
+  uint8_t slot = vrmer_keymap_slot(record->event.key);
+  if (slot == VOYAGER_NO_SLOT) {
+    return;
+  }
+  uint8_t layer = read_source_layers_cache(record->event.key);
+  if (layer < VRMER_USAGE_LAYERS) {
+    bump(layer, slot);
+  }
+  if (IS_QK_MOD_TAP(keycode) || IS_QK_LAYER_TAP(keycode)) {
+    bump(record->tap.count ? VRMER_USAGE_TAPS : VRMER_USAGE_HOLDS, slot);
+  }
+}
+
+void vrmer_usage_task(void) {
+  if (any_dirty && timer_elapsed32(last_flush) >= VRMER_USAGE_FLUSH_MS) {
+    flush();
+  }
+}
+
+void vrmer_usage_hid_read(uint8_t *data) {
+  uint8_t table = data[1];
+  uint8_t first = data[2];
+  memset(data + 1, 0, RAW_EPSIZE - 1);
+  if (table >= VRMER_USAGE_TABLES || first >= VOYAGER_SLOT_COUNT) {
+    data[1] = VRMER_HID_BAD_ARGUMENT;
+    return;
+  }
+  uint8_t count = MIN(HID_COUNTERS, VOYAGER_SLOT_COUNT - first);
+
+  uint8_t *p = data + 1;
+  *p++       = VRMER_HID_OK;
+  *p++       = VRMER_USAGE_LAYERS;
+  *p++       = table;
+  *p++       = first;
+  *p++       = count;
+  for (uint8_t i = 0; i < count; i++) {
+    uint16_t v = counters[table][first + i];
+    *p++       = v & 0xff;
+    *p++       = v >> 8;
+  }
+}
+
+void vrmer_usage_hid_reset(uint8_t *data) {
+  memset(counters, 0, sizeof(counters));
+  memset(dirty, 0xff, sizeof(dirty));
+  flush();
+  memset(data + 1, 0, RAW_EPSIZE - 1);
+  data[1] = VRMER_HID_OK;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include QMK_KEYBOARD_H
+
+#include "vrmer_keymap.h"
+
+// Per-key usage counters.
+//
+// Every key press is counted against its LAYOUT_voyager slot (k00..k51) and
+// the layer it resolved on. Tap-hold keys (mod-taps and layer-taps) also
+// count how each press ended, tap or hold, so misfiring home-row mods stand
+// out. Counters are 16-bit and stop at 0xFFFF.
+//
+// The counters live in RAM and are copied to the EEPROM user datablock in
+// batches: at most once per VRMER_USAGE_FLUSH_MS, and then only the
+// VRMER_USAGE_BLOCK-byte blocks that changed. Unplugging loses at most that
+// long of counts. They are read and cleared over raw HID (see vrmer_rawhid.h
+// and `tools/rawhid/vrmer_hid.py usage`).
+
+// Layers with their own press counters; presses on higher layers are dropped.
+#ifndef VRMER_USAGE_LAYERS
+#    define VRMER_USAGE_LAYERS 9
+#endif
+
+#ifndef VRMER_USAGE_FLUSH_MS
+#    define VRMER_USAGE_FLUSH_MS 600000
+#endif
+
+#ifndef VRMER_USAGE_BLOCK
+#    define VRMER_USAGE_BLOCK 32
+#endif
+
+// Counter tables, each indexed by slot: one per layer, then taps and holds.
+#define VRMER_USAGE_TAPS   VRMER_USAGE_LAYERS
+#define VRMER_USAGE_HOLDS  (VRMER_USAGE_LAYERS + 1)
+#define VRMER_USAGE_TABLES (VRMER_USAGE_LAYERS + 2)
+
+// Bytes of the EEPROM user datablock the counters take, from offset 0.
+#define VRMER_USAGE_EEPROM_SIZE (VRMER_USAGE_TABLES * VOYAGER_SLOT_COUNT * 2)
+
+// Load the stored counters. Call from keyboard_post_init_user.
+void vrmer_usage_init(void);
+
+// Count a key event. Call from process_record_user, which sees tap-hold keys
+// once they are decided.
+void vrmer_usage_record(uint16_t keycode, keyrecord_t *record);
+
+// Write changed blocks once the flush interval has passed. Call from
+// housekeeping_task_user.
+void vrmer_usage_task(void);
+
+// Raw HID handlers. They rewrite the RAW_EPSIZE packet in data into the reply.
+void vrmer_usage_hid_read(uint8_t *data);
+void vrmer_usage_hid_reset(uint8_t *data);